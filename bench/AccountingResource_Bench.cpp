@@ -0,0 +1,37 @@
+#include <ibex/AccountingResource.h>
+#include <ibex/SlabAllocator.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+  constexpr std::size_t kBatch = 256;
+
+  void allocateFree(benchmark::State& state,
+                    std::pmr::memory_resource& resource) {
+    std::vector<void*> blocks(kBatch);
+    for (auto _ : state) {
+      for (auto& block : blocks) block = resource.allocate(64, 8);
+      benchmark::DoNotOptimize(blocks.data());
+      for (std::size_t i = kBatch; i-- > 0;) {
+        resource.deallocate(blocks[i], 64, 8);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+  }
+}
+
+static void BM_SlabResource(benchmark::State& state) {
+  ibex::SlabAllocator slab;
+  allocateFree(state, slab);
+}
+BENCHMARK(BM_SlabResource);
+
+static void BM_AccountingOverSlab(benchmark::State& state) {
+  ibex::SlabAllocator slab;
+  ibex::MemoryTag tag("bench");
+  ibex::AccountingResource accounting(tag, &slab);
+  allocateFree(state, accounting);
+}
+BENCHMARK(BM_AccountingOverSlab);
@@ -0,0 +1,54 @@
+#include <ibex/DaryHeap.h>
+
+#include <benchmark/benchmark.h>
+
+#include <queue>
+#include <random>
+
+namespace {
+  std::vector<int> randomValues(std::size_t count) {
+    std::mt19937 rng(1);
+    std::vector<int> values(count);
+    for (auto& value : values) value = int(rng());
+    return values;
+  }
+
+  template <typename Heap>
+  void pushPop(benchmark::State& state, Heap& heap) {
+    const auto values = randomValues(std::size_t(state.range(0)));
+    for (auto _ : state) {
+      for (int value : values) heap.push(value);
+      while (!heap.empty()) {
+        benchmark::DoNotOptimize(heap.top());
+        heap.pop();
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}
+
+static void BM_StdPriorityQueue(benchmark::State& state) {
+  std::priority_queue<int> heap;
+  pushPop(state, heap);
+}
+BENCHMARK(BM_StdPriorityQueue)->Range(1 << 10, 1 << 18);
+
+template <std::size_t D>
+static void BM_DaryHeap(benchmark::State& state) {
+  ibex::DaryHeap<int, D> heap;
+  pushPop(state, heap);
+}
+BENCHMARK_TEMPLATE(BM_DaryHeap, 2)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_DaryHeap, 4)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_DaryHeap, 8)->Range(1 << 10, 1 << 18);
+
+template <std::size_t D>
+static void BM_DaryHeapHeapify(benchmark::State& state) {
+  const auto values = randomValues(std::size_t(state.range(0)));
+  ibex::DaryHeap<int, D> heap;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(heap.assign(values.begin(), values.end()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_DaryHeapHeapify, 4)->Range(1 << 10, 1 << 18);
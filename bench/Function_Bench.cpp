@@ -0,0 +1,82 @@
+#include <ibex/Function.h>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace {
+  // 64 bytes with a non-trivial copy, like a small request descriptor.
+  // Counts its copies and moves so the benchmarks can report them per call.
+  struct Descriptor {
+    inline static std::size_t copies{0};
+    inline static std::size_t moves{0};
+
+    std::string name{"a descriptor name too long for SSO"};
+    std::array<std::uint64_t, 4> values{};
+
+    Descriptor() = default;
+    Descriptor(const Descriptor& other)
+        : name(other.name), values(other.values) {
+      ++copies;
+    }
+    Descriptor(Descriptor&& other)
+        : name(std::move(other.name)), values(other.values) {
+      ++moves;
+    }
+  };
+
+  std::size_t consume(Descriptor descriptor) {
+    return descriptor.name.size() + descriptor.values[0];
+  }
+
+  // The call path of ibex::Function before arguments were forwarded by
+  // reference: by value through the public and the virtual call operator
+  struct ByValueErased {
+    virtual ~ByValueErased() = default;
+    virtual std::size_t operator()(Descriptor) = 0;
+  };
+
+  struct ByValueTarget final : ByValueErased {
+    std::size_t operator()(Descriptor descriptor) override {
+      return consume(std::move(descriptor));
+    }
+  };
+
+  struct ByValueFunction {
+    std::unique_ptr<ByValueErased> target{new ByValueTarget};
+    std::size_t operator()(Descriptor descriptor) const {
+      return (*target)(std::move(descriptor));
+    }
+  };
+
+  template <typename F>
+  void callWithLvalue(benchmark::State& state, F& f) {
+    Descriptor descriptor;
+    Descriptor::copies = Descriptor::moves = 0;
+    for (auto _ : state) benchmark::DoNotOptimize(f(descriptor));
+    const double calls = double(state.iterations());
+    state.counters["copies/call"] = double(Descriptor::copies) / calls;
+    state.counters["moves/call"] = double(Descriptor::moves) / calls;
+  }
+}
+
+static void BM_ByValueBaselineByValueArg(benchmark::State& state) {
+  ByValueFunction f;
+  callWithLvalue(state, f);
+}
+BENCHMARK(BM_ByValueBaselineByValueArg);
+
+static void BM_StdFunctionByValueArg(benchmark::State& state) {
+  std::function<std::size_t(Descriptor)> f(&consume);
+  callWithLvalue(state, f);
+}
+BENCHMARK(BM_StdFunctionByValueArg);
+
+static void BM_FunctionByValueArg(benchmark::State& state) {
+  ibex::Function<std::size_t(Descriptor), 32> f(&consume);
+  callWithLvalue(state, f);
+}
+BENCHMARK(BM_FunctionByValueArg);
@@ -0,0 +1,67 @@
+#include <ibex/Hash.h>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+  constexpr std::size_t kKeys = 1024;
+
+  // Random printable keys of the given length
+  const std::vector<std::string>& keys(std::size_t size) {
+    static std::vector<std::vector<std::string>> cache(65);
+    auto& result = cache[size];
+    if (result.empty()) {
+      std::mt19937 rng{unsigned(size)};
+      result.resize(kKeys);
+      for (auto& key : result) {
+        key.resize(size);
+        for (char& c : key) c = char('!' + rng() % 94);
+      }
+    }
+    return result;
+  }
+
+  template <typename HashFunction>
+  void hashKeys(benchmark::State& state, HashFunction hash) {
+    const auto& input = keys(std::size_t(state.range(0)));
+    for (auto _ : state) {
+      for (const std::string& key : input) {
+        benchmark::DoNotOptimize(hash(std::string_view(key)));
+      }
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * kKeys);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * kKeys *
+                            state.range(0));
+  }
+}
+
+static void BM_StdHashString(benchmark::State& state) {
+  hashKeys(state, std::hash<std::string_view>{});
+}
+BENCHMARK(BM_StdHashString)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+
+static void BM_IbexHashString(benchmark::State& state) {
+  hashKeys(state, ibex::Hash<std::string_view>{});
+}
+BENCHMARK(BM_IbexHashString)->Arg(8)->Arg(16)->Arg(32)->Arg(64);
+
+static void BM_StdHashInteger(benchmark::State& state) {
+  std::uint64_t value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::hash<std::uint64_t>{}(++value));
+  }
+}
+BENCHMARK(BM_StdHashInteger);
+
+static void BM_IbexHashInteger(benchmark::State& state) {
+  std::uint64_t value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ibex::Hash<std::uint64_t>{}(++value));
+  }
+}
+BENCHMARK(BM_IbexHashInteger);
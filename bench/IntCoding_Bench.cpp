@@ -0,0 +1,103 @@
+#include <ibex/IntCoding.h>
+#include <ibex/PackedIntVector.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+  constexpr std::size_t kCount = 1 << 16;
+
+  // Sorted IDs with gaps of 1 to 200, i.e. mostly one and two byte varints
+  const std::vector<std::uint32_t>& ids() {
+    static const std::vector<std::uint32_t> values = [] {
+      std::mt19937 rng(1);
+      std::vector<std::uint32_t> result(kCount);
+      std::uint32_t id = 0;
+      for (auto& value : result) value = id += 1 + rng() % 200;
+      return result;
+    }();
+    return values;
+  }
+
+  // Varints of random gaps below maxGap: 128 gives single bytes, 16384
+  // mostly two bytes
+  std::vector<std::uint8_t> varintGaps(std::uint32_t maxGap) {
+    std::mt19937 rng(3);
+    std::vector<std::uint32_t> gaps(kCount);
+    for (auto& gap : gaps) gap = rng() % maxGap;
+    std::vector<std::uint8_t> bytes(5 * kCount);
+    bytes.resize(ibex::encodeVarints(gaps.data(), kCount, bytes.data()));
+    return bytes;
+  }
+
+  void setItems(benchmark::State& state) {
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * kCount);
+  }
+}
+
+static void BM_VarintDecodeScalar(benchmark::State& state) {
+  const auto bytes = varintGaps(std::uint32_t(state.range(0)));
+  std::vector<std::uint32_t> out(kCount);
+  for (auto _ : state) {
+    const std::uint8_t* cursor = bytes.data();
+    for (auto& value : out) {
+      value = std::uint32_t(
+          ibex::decodeVarint(cursor, bytes.data() + bytes.size()));
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  setItems(state);
+  state.counters["bytes/value"] = double(bytes.size()) / kCount;
+}
+BENCHMARK(BM_VarintDecodeScalar)->Arg(128)->Arg(256)->Arg(16384)->Arg(1 << 24);
+
+static void BM_VarintDecodeBulk(benchmark::State& state) {
+  const auto bytes = varintGaps(std::uint32_t(state.range(0)));
+  std::vector<std::uint32_t> out(kCount);
+  for (auto _ : state) {
+    ibex::decodeVarints(bytes.data(), bytes.data() + bytes.size(), out.data(),
+                        kCount);
+    benchmark::DoNotOptimize(out.data());
+  }
+  setItems(state);
+}
+BENCHMARK(BM_VarintDecodeBulk)->Arg(128)->Arg(256)->Arg(16384)->Arg(1 << 24);
+
+static void BM_DeltaPackedDecode(benchmark::State& state) {
+  const auto words = ibex::encodeDeltaPacked(ids());
+  for (auto _ : state) {
+    auto values = ibex::decodeDeltaPacked(words);
+    benchmark::DoNotOptimize(values.data());
+  }
+  setItems(state);
+  state.counters["bytes/value"] = double(words.size() * 4) / kCount;
+}
+BENCHMARK(BM_DeltaPackedDecode);
+
+static void BM_PackedIntVectorDecode(benchmark::State& state) {
+  const ibex::PackedIntVector packed(ids());
+  std::vector<std::uint32_t> out(kCount);
+  for (auto _ : state) {
+    packed.decode(out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  setItems(state);
+  state.counters["bytes/value"] = double(packed.bytesUsed()) / kCount;
+}
+BENCHMARK(BM_PackedIntVectorDecode);
+
+static void BM_PackedIntVectorRandomAccess(benchmark::State& state) {
+  const ibex::PackedIntVector packed(ids());
+  std::mt19937 rng(2);
+  std::vector<std::size_t> indices(1024);
+  for (auto& index : indices) index = rng() % kCount;
+  for (auto _ : state) {
+    std::uint32_t sum = 0;
+    for (const std::size_t index : indices) sum += packed[index];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(std::int64_t(state.iterations()) * 1024);
+}
+BENCHMARK(BM_PackedIntVectorRandomAccess);
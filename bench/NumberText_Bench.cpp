@@ -0,0 +1,134 @@
+#include <ibex/NumberText.h>
+
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr std::size_t kCount = 1024;
+
+  // Counters and sizes as found in metrics: mostly 1 to 10 digits
+  const std::vector<std::uint64_t>& integers() {
+    static const std::vector<std::uint64_t> values = [] {
+      std::mt19937_64 rng(1);
+      std::vector<std::uint64_t> result(kCount);
+      for (auto& value : result) value = rng() >> (30 + rng() % 34);
+      return result;
+    }();
+    return values;
+  }
+
+  const std::vector<double>& floats() {
+    static const std::vector<double> values = [] {
+      std::mt19937_64 rng(2);
+      std::uniform_real_distribution<double> latency(0.0, 250.0);
+      std::vector<double> result(kCount);
+      for (auto& value : result) value = latency(rng);
+      return result;
+    }();
+    return values;
+  }
+
+  // Records of 16 digit fields, e.g. nanosecond timestamps
+  const std::string& fields() {
+    static const std::string text = [] {
+      std::mt19937_64 rng(3);
+      std::string result(16 * kCount, '0');
+      for (std::size_t i = 0; i < kCount; ++i) {
+        ibex::formatDigits(result.data() + 16 * i, rng(), 16);
+      }
+      return result;
+    }();
+    return text;
+  }
+
+  void setItems(benchmark::State& state) {
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * kCount);
+  }
+}
+
+static void BM_FormatIntegerSnprintf(benchmark::State& state) {
+  char buffer[32];
+  for (auto _ : state) {
+    for (const std::uint64_t value : integers()) {
+      benchmark::DoNotOptimize(std::snprintf(buffer, sizeof(buffer), "%llu",
+                                             (unsigned long long)value));
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_FormatIntegerSnprintf);
+
+static void BM_FormatIntegerToChars(benchmark::State& state) {
+  char buffer[ibex::kMaxIntegerChars];
+  for (auto _ : state) {
+    for (const std::uint64_t value : integers()) {
+      benchmark::DoNotOptimize(
+          std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_FormatIntegerToChars);
+
+static void BM_FormatInteger(benchmark::State& state) {
+  char buffer[ibex::kMaxIntegerChars];
+  for (auto _ : state) {
+    for (const std::uint64_t value : integers()) {
+      benchmark::DoNotOptimize(ibex::formatInteger(buffer, value));
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_FormatInteger);
+
+static void BM_FormatFloatSnprintf(benchmark::State& state) {
+  char buffer[32];
+  for (auto _ : state) {
+    for (const double value : floats()) {
+      benchmark::DoNotOptimize(
+          std::snprintf(buffer, sizeof(buffer), "%.17g", value));
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_FormatFloatSnprintf);
+
+static void BM_FormatFloat(benchmark::State& state) {
+  char buffer[ibex::kMaxFloatChars];
+  for (auto _ : state) {
+    for (const double value : floats()) {
+      benchmark::DoNotOptimize(ibex::formatFloat(buffer, value));
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_FormatFloat);
+
+static void BM_ParseDigitsFromChars(benchmark::State& state) {
+  const std::string& text = fields();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < text.size(); i += 16) {
+      std::uint64_t value;
+      std::from_chars(text.data() + i, text.data() + i + 16, value);
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_ParseDigitsFromChars);
+
+static void BM_ParseDigits(benchmark::State& state) {
+  const std::string& text = fields();
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < text.size(); i += 16) {
+      benchmark::DoNotOptimize(ibex::parseDigits(text.data() + i, 16));
+    }
+  }
+  setItems(state);
+}
+BENCHMARK(BM_ParseDigits);
@@ -0,0 +1,79 @@
+#include <ibex/RecordReader.h>
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  // A 64 MiB log-like file with lines of 20 to 200 bytes, written once
+  const std::string& logFile() {
+    static const std::string path = [] {
+      const std::string file =
+          (std::filesystem::temp_directory_path() / "ibex_bench.log").string();
+      std::mt19937 rng(1);
+      std::ofstream out(file, std::ios::binary);
+      std::size_t written = 0;
+      while (written < 64 * 1024 * 1024) {
+        const std::string line(20 + rng() % 180, 'x');
+        out << line << '\n';
+        written += line.size() + 1;
+      }
+      return file;
+    }();
+    return path;
+  }
+
+  void setBytes(benchmark::State& state) {
+    state.SetBytesProcessed(
+        std::int64_t(state.iterations()) *
+        std::int64_t(std::filesystem::file_size(logFile())));
+  }
+}
+
+static void BM_Getline(benchmark::State& state) {
+  for (auto _ : state) {
+    std::ifstream in(logFile(), std::ios::binary);
+    std::string line;
+    std::size_t bytes = 0;
+    while (std::getline(in, line)) bytes += line.size();
+    benchmark::DoNotOptimize(bytes);
+  }
+  setBytes(state);
+}
+BENCHMARK(BM_Getline)->Unit(benchmark::kMillisecond);
+
+static void BM_RecordReader(benchmark::State& state) {
+  for (auto _ : state) {
+    ibex::RecordReader reader(logFile());
+    std::size_t bytes = 0;
+    reader.forEach([&](std::string_view line) { bytes += line.size(); });
+    benchmark::DoNotOptimize(bytes);
+  }
+  setBytes(state);
+}
+BENCHMARK(BM_RecordReader)->Unit(benchmark::kMillisecond);
+
+static void BM_RecordReaderParallel(benchmark::State& state) {
+  struct alignas(64) Counter {
+    std::size_t bytes{0};
+  };
+  for (auto _ : state) {
+    ibex::RecordReader reader(logFile());
+    std::vector<Counter> counters(reader.split(8 * 1024 * 1024).size());
+    reader.forEachParallel(
+        [&](std::size_t chunk, std::string_view line) {
+          counters[chunk].bytes += line.size();
+        },
+        std::size_t(state.range(0)));
+    benchmark::DoNotOptimize(counters.data());
+  }
+  setBytes(state);
+}
+BENCHMARK(BM_RecordReaderParallel)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,107 @@
+#include <ibex/SlabAllocator.h>
+
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+  constexpr std::size_t kBatch = 256;
+
+  struct Malloc {
+    void* allocate(std::size_t size) { return std::malloc(size); }
+    void deallocate(void* block, std::size_t) { std::free(block); }
+  };
+
+  struct Slab {
+    ibex::SlabAllocator allocator;
+    void* allocate(std::size_t size) { return allocator.allocate(size, 8); }
+    void deallocate(void* block, std::size_t size) {
+      allocator.deallocate(block, size, 8);
+    }
+  };
+
+  // Allocates and frees on the same thread, in LIFO order
+  template <typename Allocator>
+  void localFree(benchmark::State& state, Allocator& allocator) {
+    const auto size = std::size_t(state.range(0));
+    std::vector<void*> blocks(kBatch);
+    for (auto _ : state) {
+      for (auto& block : blocks) block = allocator.allocate(size);
+      benchmark::DoNotOptimize(blocks.data());
+      for (std::size_t i = kBatch; i-- > 0;) {
+        allocator.deallocate(blocks[i], size);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+  }
+
+  // Allocates on the benchmark thread and frees every block on a consumer
+  // thread, the pattern of a message passing pipeline
+  template <typename Allocator>
+  void remoteFree(benchmark::State& state, Allocator& allocator) {
+    const auto size = std::size_t(state.range(0));
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<std::vector<void*>> batches;
+    bool stop = false;
+
+    std::thread consumer([&] {
+      std::unique_lock<std::mutex> lock(mutex);
+      for (;;) {
+        wakeup.wait(lock, [&] { return stop || !batches.empty(); });
+        if (batches.empty()) break;
+        std::vector<void*> batch = std::move(batches.front());
+        batches.pop_front();
+        lock.unlock();
+        for (void* block : batch) allocator.deallocate(block, size);
+        lock.lock();
+      }
+    });
+
+    for (auto _ : state) {
+      std::vector<void*> batch(kBatch);
+      for (auto& block : batch) block = allocator.allocate(size);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(std::move(batch));
+      }
+      wakeup.notify_one();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    wakeup.notify_one();
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * kBatch);
+  }
+}
+
+static void BM_MallocLocalFree(benchmark::State& state) {
+  Malloc allocator;
+  localFree(state, allocator);
+}
+BENCHMARK(BM_MallocLocalFree)->Arg(16)->Arg(64)->Arg(512);
+
+static void BM_SlabLocalFree(benchmark::State& state) {
+  Slab allocator;
+  localFree(state, allocator);
+}
+BENCHMARK(BM_SlabLocalFree)->Arg(16)->Arg(64)->Arg(512);
+
+static void BM_MallocRemoteFree(benchmark::State& state) {
+  Malloc allocator;
+  remoteFree(state, allocator);
+}
+BENCHMARK(BM_MallocRemoteFree)->Arg(16)->Arg(64)->Arg(512);
+
+static void BM_SlabRemoteFree(benchmark::State& state) {
+  Slab allocator;
+  remoteFree(state, allocator);
+}
+BENCHMARK(BM_SlabRemoteFree)->Arg(16)->Arg(64)->Arg(512);
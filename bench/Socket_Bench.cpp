@@ -0,0 +1,51 @@
+#include <ibex/Socket.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+  constexpr std::size_t kBatch = 64;
+  constexpr std::size_t kPayload = 128;
+}
+
+// One sendto() and one recvfrom() per datagram
+static void BM_UdpPerDatagram(benchmark::State& state) {
+  ibex::UdpSocket receiver(ibex::SocketAddress::loopback());
+  ibex::UdpSocket sender(ibex::SocketAddress::loopback());
+  const ibex::SocketAddress target = receiver.localAddress();
+  std::vector<char> payload(kPayload, 'x');
+  std::vector<char> buffer(2048);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kBatch; ++i) {
+      ::sendto(sender.fd(), payload.data(), payload.size(), 0, target.get(),
+               target.length());
+    }
+    for (std::size_t i = 0; i < kBatch; ++i) {
+      sockaddr_storage peer;
+      socklen_t length = sizeof(peer);
+      ::recvfrom(receiver.fd(), buffer.data(), buffer.size(), 0,
+                 reinterpret_cast<sockaddr*>(&peer), &length);
+    }
+  }
+  state.SetItemsProcessed(std::int64_t(state.iterations()) * kBatch);
+}
+BENCHMARK(BM_UdpPerDatagram);
+
+// One sendmmsg() and one recvmmsg() per batch
+static void BM_UdpBatched(benchmark::State& state) {
+  ibex::UdpSocket receiver(ibex::SocketAddress::loopback());
+  ibex::UdpSocket sender(ibex::SocketAddress::loopback());
+  const ibex::SocketAddress target = receiver.localAddress();
+  std::vector<std::byte> payload(kPayload);
+  const std::vector<ibex::Datagram> datagrams(
+      kBatch, ibex::Datagram{payload.data(), payload.size(), target});
+  ibex::DatagramBatch batch(kBatch);
+  for (auto _ : state) {
+    sender.send(datagrams.data(), datagrams.size());
+    std::size_t received = 0;
+    while (received < kBatch) received += receiver.receive(batch);
+  }
+  state.SetItemsProcessed(std::int64_t(state.iterations()) * kBatch);
+}
+BENCHMARK(BM_UdpBatched);
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+namespace detail {
+
+inline constexpr std::size_t kCounterShards = 64;
+
+// Hands out shard indices to threads. A thread owns its shard exclusively and
+// returns it when it exits; threads beyond kCounterShards share the last one.
+class ShardRegistry final {
+ private:
+  std::mutex m_mutex;
+  std::vector<std::size_t> m_free;
+  std::size_t m_next{0};
+
+ public:
+  static ShardRegistry& instance() {
+    static ShardRegistry registry;
+    return registry;
+  }
+
+  std::size_t acquire() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_free.empty()) {
+      const std::size_t index = m_free.back();
+      m_free.pop_back();
+      return index;
+    }
+    return m_next < kCounterShards ? m_next++ : kCounterShards;
+  }
+
+  void release(std::size_t index) {
+    if (index == kCounterShards) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(index);
+  }
+};
+
+// Acquires a shard for the calling thread and releases it on thread exit
+inline std::size_t acquireCounterShard() {
+  thread_local struct Slot {
+    std::size_t index = ShardRegistry::instance().acquire();
+    ~Slot() { ShardRegistry::instance().release(index); }
+  } slot;
+  return slot.index;
+}
+
+// Shard index of the calling thread, kCounterShards if it has to share. The
+// plain thread_local avoids the initialization guard on every access.
+inline std::size_t counterShard() {
+  thread_local std::size_t index = SIZE_MAX;
+  if (index == SIZE_MAX) index = acquireCounterShard();
+  return index;
+}
+
+}  // namespace detail
+
+///
+/// @brief      Names a subsystem that memory is charged to. Tags form a tree,
+///             e.g. "net" with the children "net/buffers" and "net/sessions",
+///             and the statistics of a tag include those of its children.
+///
+///             Counters are sharded per thread, so charging memory is a few
+///             plain loads and stores to a cache line owned by the calling
+///             thread. Live bytes are additionally folded into a shared total
+///             every 64 KiB per thread, which is what the peak is tracked on;
+///             it may therefore be off by up to 64 KiB per charging thread.
+///
+///             A tag must outlive the resources charging it, and a parent its
+///             children.
+///
+class MemoryTag final {
+ public:
+  struct Stats {
+    std::uint64_t allocations;
+    std::uint64_t deallocations;
+    std::int64_t liveBytes;
+    std::int64_t peakBytes;
+  };
+
+  // Granularity at which live bytes are folded into the peak
+  static constexpr std::int64_t kPeakGranularity = 64 * 1024;
+
+ private:
+  // Written by the owning thread only, unless it is the shared last shard
+  struct alignas(64) Shard {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::int64_t> bytes{0};       // Allocated minus freed
+    std::atomic<std::int64_t> unreported{0};  // Not yet folded into m_live
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::string m_name;
+  MemoryTag* m_parent;
+  std::array<Shard, detail::kCounterShards + 1> m_shards;
+  // Live and peak bytes of this tag and its children, at kPeakGranularity
+  std::atomic<std::int64_t> m_live{0};
+  std::atomic<std::int64_t> m_peak{0};
+  std::vector<MemoryTag*> m_children;  // Guarded by treeMutex()
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Creates a tag.
+  ///
+  /// @param      name    Name of the subsystem.
+  /// @param      parent  Enclosing subsystem, or nullptr for a root tag.
+  ///
+  explicit MemoryTag(std::string name, MemoryTag* parent = nullptr)
+      : m_name(std::move(name)), m_parent(parent) {
+    if (m_parent != nullptr) {
+      std::lock_guard<std::mutex> lock(treeMutex());
+      m_parent->m_children.push_back(this);
+    }
+  }
+
+  MemoryTag(const MemoryTag&) = delete;
+  MemoryTag& operator=(const MemoryTag&) = delete;
+
+  ~MemoryTag() {
+    if (m_parent != nullptr) {
+      std::lock_guard<std::mutex> lock(treeMutex());
+      auto& siblings = m_parent->m_children;
+      siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    }
+  }
+
+  const std::string& name() const { return m_name; }
+  MemoryTag* parent() const { return m_parent; }
+
+  // Names from the root down to this tag, separated by '/'
+  std::string path() const {
+    return m_parent == nullptr ? m_name : m_parent->path() + "/" + m_name;
+  }
+
+  // Child tags at the time of the call
+  std::vector<MemoryTag*> children() const {
+    std::lock_guard<std::mutex> lock(treeMutex());
+    return m_children;
+  }
+
+  // Record an allocation of bytes
+  void charge(std::size_t bytes) {
+    const std::size_t index = detail::counterShard();
+    Shard& shard = m_shards[index];
+    const bool owned = index != detail::kCounterShards;
+    add(shard.allocations, std::uint64_t(1), owned);
+    add(shard.bytes, std::int64_t(bytes), owned);
+    report(shard, std::int64_t(bytes), owned);
+  }
+
+  // Record a deallocation of bytes, from any thread
+  void release(std::size_t bytes) {
+    const std::size_t index = detail::counterShard();
+    Shard& shard = m_shards[index];
+    const bool owned = index != detail::kCounterShards;
+    add(shard.deallocations, std::uint64_t(1), owned);
+    add(shard.bytes, -std::int64_t(bytes), owned);
+    report(shard, -std::int64_t(bytes), owned);
+  }
+
+  ///
+  /// @brief      Counters of this tag and all its children. The counts and
+  ///             live bytes are exact once concurrent charges have finished.
+  ///
+  Stats stats() const {
+    Stats stats{0, 0, 0, m_peak.load(std::memory_order_relaxed)};
+    accumulate(stats);
+    stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+    return stats;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  static std::mutex& treeMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  template <typename T>
+  static T add(std::atomic<T>& counter, T value, bool owned) {
+    if (owned) {
+      const T result = counter.load(std::memory_order_relaxed) + value;
+      counter.store(result, std::memory_order_relaxed);
+      return result;
+    }
+    return counter.fetch_add(value, std::memory_order_relaxed) + value;
+  }
+
+  // Fold the live bytes of a shard into the totals of this tag and its
+  // ancestors once they have drifted by kPeakGranularity
+  void report(Shard& shard, std::int64_t bytes, bool owned) {
+    const std::int64_t unreported = add(shard.unreported, bytes, owned);
+    if (unreported < kPeakGranularity && unreported > -kPeakGranularity) {
+      return;
+    }
+    const std::int64_t delta =
+        shard.unreported.exchange(0, std::memory_order_relaxed);
+    for (MemoryTag* tag = this; tag != nullptr; tag = tag->m_parent) {
+      const std::int64_t live =
+          tag->m_live.fetch_add(delta, std::memory_order_relaxed) + delta;
+      std::int64_t peak = tag->m_peak.load(std::memory_order_relaxed);
+      while (live > peak &&
+             !tag->m_peak.compare_exchange_weak(peak, live,
+                                                std::memory_order_relaxed)) {
+      }
+    }
+  }
+
+  void accumulate(Stats& stats) const {
+    for (const Shard& shard : m_shards) {
+      stats.allocations += shard.allocations.load(std::memory_order_relaxed);
+      stats.deallocations +=
+          shard.deallocations.load(std::memory_order_relaxed);
+      stats.liveBytes += shard.bytes.load(std::memory_order_relaxed);
+    }
+    for (const MemoryTag* child : children()) child->accumulate(stats);
+  }
+};
+
+///
+/// @brief      A std::pmr::memory_resource that passes all requests on to an
+///             upstream resource and charges them to a MemoryTag.
+///             It can be layered over any resource, e.g. an ibex::Arena or an
+///             ibex::SlabAllocator, and several resources can charge one tag.
+///
+class AccountingResource final : public std::pmr::memory_resource {
+ private:
+  std::pmr::memory_resource* m_upstream;
+  MemoryTag& m_tag;
+
+ public:
+  ///
+  /// @param      tag       Tag to charge, must outlive this resource.
+  /// @param      upstream  Resource that provides the memory.
+  ///
+  explicit AccountingResource(
+      MemoryTag& tag,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : m_upstream(upstream), m_tag(tag) {}
+
+  MemoryTag& tag() const { return m_tag; }
+  std::pmr::memory_resource* upstream() const { return m_upstream; }
+
+ private:
+  void* do_allocate(std::size_t size, std::size_t alignment) override {
+    void* pointer = m_upstream->allocate(size, alignment);
+    m_tag.charge(size);
+    return pointer;
+  }
+
+  void do_deallocate(void* pointer, std::size_t size,
+                     std::size_t alignment) override {
+    m_upstream->deallocate(pointer, size, alignment);
+    m_tag.release(size);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <ibex/PageMemory.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      A bump allocator over large chunks of PageMemory.
+///             Allocation is a pointer increment; memory is only released as
+///             a whole by reset(), which keeps the chunks for reuse, or by
+///             destroying the arena. Destructors of objects created in the
+///             arena are not run.
+///             Chunks can be backed by huge pages and prefaulted, see
+///             PageOptions. Not thread-safe.
+///             As a std::pmr::memory_resource it behaves like
+///             std::pmr::monotonic_buffer_resource: deallocation is a no-op.
+///
+class Arena final : public std::pmr::memory_resource {
+ private:
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::vector<PageMemory> m_chunks;
+  std::size_t m_current{0};  // Chunk allocations are served from
+  std::uintptr_t m_cursor{0};
+  std::uintptr_t m_end{0};
+  std::size_t m_chunkSize;
+  PageOptions m_options;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Creates an arena. Chunks are mapped on demand, or up front
+  ///             by reserve().
+  ///
+  /// @param      chunkSize  Size of the chunks. Larger allocations get a chunk
+  ///                        of their own.
+  /// @param      options    Huge page and prefault options for the chunks.
+  ///
+  explicit Arena(std::size_t chunkSize = PageMemory::kHugePageSize,
+                 PageOptions options = {})
+      : m_chunkSize(chunkSize), m_options(options) {}
+
+  // The moved-from arena is empty, like a newly created one
+  Arena(Arena&& other)
+      : m_chunks(std::exchange(other.m_chunks, {})),
+        m_current(std::exchange(other.m_current, 0)),
+        m_cursor(std::exchange(other.m_cursor, 0)),
+        m_end(std::exchange(other.m_end, 0)),
+        m_chunkSize(other.m_chunkSize),
+        m_options(other.m_options) {}
+
+  Arena& operator=(Arena&& other) {
+    if (this != &other) {
+      m_chunks = std::exchange(other.m_chunks, {});
+      m_current = std::exchange(other.m_current, 0);
+      m_cursor = std::exchange(other.m_cursor, 0);
+      m_end = std::exchange(other.m_end, 0);
+      m_chunkSize = other.m_chunkSize;
+      m_options = other.m_options;
+    }
+    return *this;
+  }
+
+  ///
+  /// @brief      Returns size bytes aligned to alignment.
+  ///             Throws std::bad_alloc if no memory can be mapped.
+  ///
+  void* allocate(std::size_t size,
+                 std::size_t alignment = alignof(std::max_align_t)) {
+    std::uintptr_t start = alignUp(m_cursor, alignment);
+    if (m_chunks.empty() || start + size > m_end) {
+      nextChunk(size + alignment);
+      start = alignUp(m_cursor, alignment);
+    }
+    m_cursor = start + size;
+    return reinterpret_cast<void*>(start);
+  }
+
+  // Constructs a T in the arena. Its destructor is never called.
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    return new (allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+  }
+
+  // Maps and, if requested, prefaults chunks for at least bytes more bytes
+  void reserve(std::size_t bytes) {
+    std::size_t available = m_chunks.empty() ? 0 : m_end - m_cursor;
+    for (std::size_t c = m_current + 1; c < m_chunks.size(); ++c) {
+      available += m_chunks[c].size();
+    }
+    while (available < bytes) {
+      m_chunks.emplace_back(m_chunkSize, m_options);
+      available += m_chunks.back().size();
+    }
+    if (m_cursor == 0) select(0);
+  }
+
+  // Release all allocations at once, keeping the chunks
+  void reset() {
+    if (!m_chunks.empty()) select(0);
+  }
+
+  // Bytes mapped for this arena
+  std::size_t bytesReserved() const {
+    std::size_t bytes = 0;
+    for (const PageMemory& chunk : m_chunks) bytes += chunk.size();
+    return bytes;
+  }
+
+  // Bytes of the mapped chunks that are backed by huge pages
+  std::size_t hugePageBytes() const {
+    std::size_t bytes = 0;
+    for (const PageMemory& chunk : m_chunks) bytes += chunk.hugePageBytes();
+    return bytes;
+  }
+
+  // ---------------------------------------------------------------------------
+  // std::pmr::memory_resource
+  // ---------------------------------------------------------------------------
+ private:
+  void* do_allocate(std::size_t size, std::size_t alignment) override {
+    return allocate(size, alignment);
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+  static std::uintptr_t alignUp(std::uintptr_t n, std::size_t alignment) {
+    return (n + alignment - 1) & ~std::uintptr_t(alignment - 1);
+  }
+
+  void select(std::size_t chunk) {
+    m_current = chunk;
+    m_cursor = reinterpret_cast<std::uintptr_t>(m_chunks[chunk].data());
+    m_end = m_cursor + m_chunks[chunk].size();
+  }
+
+  // Move on to the next chunk with at least size bytes, mapping it if needed
+  void nextChunk(std::size_t size) {
+    std::size_t next = m_chunks.empty() ? 0 : m_current + 1;
+    while (next < m_chunks.size() && m_chunks[next].size() < size) ++next;
+    if (next == m_chunks.size()) {
+      m_chunks.emplace_back(size > m_chunkSize ? size : m_chunkSize,
+                            m_options);
+    }
+    select(next);
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,459 @@
+#pragma once
+
+#include <ibex/Pool.h>
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+class BufferChain;
+
+// ---------------------------------------------------------------------------
+// BufferPool
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Hands out reference counted memory blocks for BufferChains,
+///             carved from an ibex::Pool. Blocks can be released from any
+///             thread. The pool must outlive all chains using it.
+///
+class BufferPool final {
+ private:
+  friend class BufferChain;
+
+  // Start of every block, followed by the payload
+  struct alignas(std::max_align_t) Block {
+    std::atomic<std::uint32_t> references{1};
+    BufferPool* pool;
+
+    explicit Block(BufferPool* owner) : pool(owner) {}
+
+    std::byte* payload() { return reinterpret_cast<std::byte*>(this + 1); }
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::mutex m_mutex;
+  Pool m_pool;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @param      blockSize       Size of each block including a small header.
+  /// @param      blocksPerChunk  Number of blocks mapped at once.
+  /// @param      options         Huge page and prefault options.
+  ///
+  explicit BufferPool(std::size_t blockSize = 16 * 1024,
+                      std::size_t blocksPerChunk = 64,
+                      PageOptions options = {})
+      : m_pool(blockSize, blocksPerChunk, options) {}
+
+  // Payload bytes per block
+  std::size_t blockCapacity() const {
+    return m_pool.blockSize() - sizeof(Block);
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  Block* acquire() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return new (m_pool.allocate()) Block(this);
+  }
+
+  static void retain(Block* block) {
+    block->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static void release(Block* block) {
+    if (block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      BufferPool& pool = *block->pool;
+      block->~Block();
+      std::lock_guard<std::mutex> lock(pool.m_mutex);
+      pool.m_pool.deallocate(block);
+    }
+  }
+};
+
+// ---------------------------------------------------------------------------
+// BufferChain
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      A byte sequence made of slices of reference counted blocks
+///             from a BufferPool. Splitting, appending another chain and
+///             trimming only adjust slices and reference counts; payload bytes
+///             are copied once, when they enter the chain, or not at all when
+///             read into it with prepare()/commit().
+///             A chain converts to an iovec array for readv/writev, and a
+///             Cursor parses values that straddle slice boundaries.
+///             A chain is not thread-safe, but chains sharing blocks can be
+///             used on different threads.
+///
+class BufferChain final {
+ private:
+  using Block = BufferPool::Block;
+
+  // A reference to bytes [offset, offset + length) of a block's payload
+  struct Slice {
+    Block* block;
+    std::uint32_t offset;
+    std::uint32_t length;
+
+    std::byte* data() const { return block->payload() + offset; }
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  BufferPool* m_pool;
+  std::deque<Slice> m_slices;
+  std::size_t m_size{0};
+  Block* m_pending{nullptr};  // Handed out by prepare(), not committed yet
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  class Cursor;
+
+  explicit BufferChain(BufferPool& pool) : m_pool(&pool) {}
+
+  BufferChain(const BufferChain& other)
+      : m_pool(other.m_pool), m_slices(other.m_slices), m_size(other.m_size) {
+    for (const Slice& slice : m_slices) BufferPool::retain(slice.block);
+  }
+
+  BufferChain(BufferChain&& other)
+      : m_pool(other.m_pool),
+        m_slices(std::move(other.m_slices)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_pending(std::exchange(other.m_pending, nullptr)) {
+    other.m_slices.clear();
+  }
+
+  BufferChain& operator=(BufferChain other) {
+    std::swap(m_pool, other.m_pool);
+    std::swap(m_slices, other.m_slices);
+    std::swap(m_size, other.m_size);
+    std::swap(m_pending, other.m_pending);
+    return *this;
+  }
+
+  ~BufferChain() {
+    clear();
+    if (m_pending != nullptr) BufferPool::release(m_pending);
+  }
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  std::size_t sliceCount() const { return m_slices.size(); }
+
+  // Copy bytes into the chain, filling the last block before taking new ones
+  void append(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const std::byte*>(data);
+    while (size > 0) {
+      auto [destination, free] = prepare(1);
+      const std::size_t count = free < size ? free : size;
+      std::memcpy(destination, bytes, count);
+      commit(count);
+      bytes += count;
+      size -= count;
+    }
+  }
+
+  void append(const std::string& text) { append(text.data(), text.size()); }
+
+  // Append the slices of other, which is left empty
+  void append(BufferChain&& other) {
+    for (const Slice& slice : other.m_slices) m_slices.push_back(slice);
+    m_size += std::exchange(other.m_size, 0);
+    other.m_slices.clear();
+  }
+
+  // Append the slices of other, sharing its blocks
+  void append(const BufferChain& other) { append(BufferChain(other)); }
+
+  ///
+  /// @brief      Returns writable memory at the end of the chain, e.g. for
+  ///             read(). Only the bytes passed to commit() become part of the
+  ///             chain. The free end of the last block is reused as long as no
+  ///             other chain shares that block.
+  ///
+  /// @param      minimum  Required contiguous bytes, at most the capacity of
+  ///                      a block.
+  ///
+  std::pair<std::byte*, std::size_t> prepare(std::size_t minimum) {
+    const std::size_t capacity = m_pool->blockCapacity();
+    if (minimum > capacity) {
+      throw std::length_error("BufferChain: request exceeds block capacity");
+    }
+    if (m_pending == nullptr && !m_slices.empty()) {
+      const Slice& last = m_slices.back();
+      const std::size_t end = last.offset + last.length;
+      if (capacity - end >= minimum && isExclusive(last.block)) {
+        return {last.data() + last.length, capacity - end};
+      }
+    }
+    if (m_pending == nullptr) m_pending = m_pool->acquire();
+    return {m_pending->payload(), capacity};
+  }
+
+  ///
+  /// @brief      Appends bytes written to the memory returned by the last
+  ///             prepare().
+  ///
+  void commit(std::size_t bytes) {
+    if (m_pending != nullptr) {
+      if (bytes == 0) return;
+      m_slices.push_back(Slice{std::exchange(m_pending, nullptr), 0,
+                               std::uint32_t(bytes)});
+    } else if (bytes > 0) {
+      m_slices.back().length += std::uint32_t(bytes);
+    }
+    m_size += bytes;
+  }
+
+  ///
+  /// @brief      Removes the first bytes from the chain and returns them as a
+  ///             chain of their own. A slice crossing the boundary is shared.
+  ///
+  BufferChain split(std::size_t bytes) {
+    checkSize(bytes);
+    BufferChain head(*m_pool);
+    while (bytes > 0) {
+      Slice& front = m_slices.front();
+      if (front.length <= bytes) {
+        head.m_slices.push_back(front);
+        bytes -= front.length;
+        head.m_size += front.length;
+        m_size -= front.length;
+        m_slices.pop_front();
+      } else {
+        BufferPool::retain(front.block);
+        head.m_slices.push_back(
+            Slice{front.block, front.offset, std::uint32_t(bytes)});
+        head.m_size += bytes;
+        trimFront(bytes);
+        bytes = 0;
+      }
+    }
+    return head;
+  }
+
+  // Drop the first bytes
+  void trimFront(std::size_t bytes) {
+    checkSize(bytes);
+    m_size -= bytes;
+    while (bytes > 0) {
+      Slice& front = m_slices.front();
+      if (front.length <= bytes) {
+        bytes -= front.length;
+        BufferPool::release(front.block);
+        m_slices.pop_front();
+      } else {
+        front.offset += std::uint32_t(bytes);
+        front.length -= std::uint32_t(bytes);
+        bytes = 0;
+      }
+    }
+  }
+
+  // Drop the last bytes
+  void trimBack(std::size_t bytes) {
+    checkSize(bytes);
+    m_size -= bytes;
+    while (bytes > 0) {
+      Slice& back = m_slices.back();
+      if (back.length <= bytes) {
+        bytes -= back.length;
+        BufferPool::release(back.block);
+        m_slices.pop_back();
+      } else {
+        back.length -= std::uint32_t(bytes);
+        bytes = 0;
+      }
+    }
+  }
+
+  void clear() {
+    for (const Slice& slice : m_slices) BufferPool::release(slice.block);
+    m_slices.clear();
+    m_size = 0;
+  }
+
+  ///
+  /// @brief      Fills vectors with up to count slices, for readv/writev.
+  ///
+  /// @return     Number of filled entries.
+  ///
+  std::size_t toIovec(iovec* vectors, std::size_t count) const {
+    std::size_t filled = 0;
+    for (const Slice& slice : m_slices) {
+      if (filled == count) break;
+      vectors[filled++] = iovec{slice.data(), slice.length};
+    }
+    return filled;
+  }
+
+  std::vector<iovec> toIovec() const {
+    std::vector<iovec> vectors(m_slices.size());
+    toIovec(vectors.data(), vectors.size());
+    return vectors;
+  }
+
+  // Call f(const std::byte* data, std::size_t size) for every slice
+  template <typename Visitor>
+  void forEachSlice(Visitor&& f) const {
+    for (const Slice& slice : m_slices) {
+      f(static_cast<const std::byte*>(slice.data()),
+        std::size_t(slice.length));
+    }
+  }
+
+  // Copy all bytes into a contiguous string
+  std::string toString() const {
+    std::string text;
+    text.reserve(m_size);
+    forEachSlice([&](const std::byte* data, std::size_t size) {
+      text.append(reinterpret_cast<const char*>(data), size);
+    });
+    return text;
+  }
+
+  Cursor cursor() const;
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  void checkSize(std::size_t bytes) const {
+    if (bytes > m_size) {
+      throw std::out_of_range("BufferChain: not enough bytes");
+    }
+  }
+
+  // Whether only this chain references block, so its free end can be written
+  static bool isExclusive(Block* block) {
+    return block->references.load(std::memory_order_acquire) == 1;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// BufferChain::Cursor
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Reads a BufferChain front to back without copying it, across
+///             slice boundaries. The chain must not be modified while a cursor
+///             is in use.
+///
+class BufferChain::Cursor final {
+ private:
+  const std::deque<Slice>* m_slices;
+  std::size_t m_index{0};   // Current slice
+  std::size_t m_offset{0};  // Offset in the current slice
+  std::size_t m_remaining;
+
+ public:
+  explicit Cursor(const BufferChain& chain)
+      : m_slices(&chain.m_slices), m_remaining(chain.m_size) {}
+
+  // Bytes left to read
+  std::size_t remaining() const { return m_remaining; }
+
+  // Copy the next size bytes to destination. Throws std::out_of_range if
+  // fewer are left, without consuming any.
+  void read(void* destination, std::size_t size) {
+    check(size);
+    auto* bytes = static_cast<std::byte*>(destination);
+    while (size > 0) {
+      const Slice& slice = (*m_slices)[m_index];
+      const std::size_t available = slice.length - m_offset;
+      const std::size_t count = available < size ? available : size;
+      std::memcpy(bytes, slice.data() + m_offset, count);
+      bytes += count;
+      size -= count;
+      advance(count);
+    }
+  }
+
+  // Read a trivially copyable value in host byte order
+  template <typename T>
+  T read() {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be read (T).");
+    T value;
+    read(&value, sizeof(T));
+    return value;
+  }
+
+  // Like read<T>(), but without consuming the value
+  template <typename T>
+  T peek() const {
+    Cursor copy = *this;
+    return copy.read<T>();
+  }
+
+  std::string readString(std::size_t size) {
+    std::string text(size, '\0');
+    read(text.data(), size);
+    return text;
+  }
+
+  void skip(std::size_t size) {
+    check(size);
+    while (size > 0) {
+      const std::size_t available = (*m_slices)[m_index].length - m_offset;
+      const std::size_t count = available < size ? available : size;
+      size -= count;
+      advance(count);
+    }
+  }
+
+  // The unread bytes of the current slice, readable in place
+  std::pair<const std::byte*, std::size_t> contiguous() const {
+    if (m_remaining == 0) return {nullptr, 0};
+    const Slice& slice = (*m_slices)[m_index];
+    return {slice.data() + m_offset, slice.length - m_offset};
+  }
+
+ private:
+  void check(std::size_t size) const {
+    if (size > m_remaining) {
+      throw std::out_of_range("BufferChain::Cursor: not enough bytes");
+    }
+  }
+
+  void advance(std::size_t count) {
+    m_offset += count;
+    m_remaining -= count;
+    if (m_offset == (*m_slices)[m_index].length) {
+      ++m_index;
+      m_offset = 0;
+    }
+  }
+};
+
+inline BufferChain::Cursor BufferChain::cursor() const {
+  return Cursor(*this);
+}
+
+}  // namespace ibex
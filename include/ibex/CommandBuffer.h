@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      Records callables of arbitrary size back-to-back in memory
+///             blocks and replays them in order.
+///             Unlike a vector of ibex::Function, every record only takes as
+///             much space as its capture plus a 16 byte header holding a thunk
+///             and the record size, and replaying walks memory sequentially.
+///             Blocks are kept on reset(), which is O(1) if no recorded
+///             callable needs its destructor run.
+///
+class CommandBuffer final {
+ private:
+  enum class Action { Invoke, Destroy };
+
+  // Precedes every recorded callable
+  struct Header {
+    void (*thunk)(void* capture, Action action);
+    std::uint32_t size;    // Bytes from this header to the next one
+    std::uint32_t offset;  // Bytes from this header to the capture
+  };
+
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    std::size_t capacity;
+    std::size_t used{0};
+  };
+
+  static constexpr std::size_t kBlockAlignment =
+      __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::vector<Block> m_blocks;
+  std::size_t m_current{0};
+  Header* m_last{nullptr};  // Most recent record of the current block
+  std::size_t m_blockSize;
+  std::size_t m_size{0};
+  bool m_needsDestroy{false};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Creates an empty buffer. No memory is allocated until the
+  ///             first callable is recorded.
+  ///
+  /// @param      blockSize  Size of the memory blocks in bytes. Callables
+  ///                        larger than this get a block of their own.
+  ///
+  explicit CommandBuffer(std::size_t blockSize = 16 * 1024)
+      : m_blockSize(blockSize) {}
+
+  CommandBuffer(CommandBuffer&& other)
+      : m_blocks(std::move(other.m_blocks)),
+        m_current(std::exchange(other.m_current, 0)),
+        m_last(std::exchange(other.m_last, nullptr)),
+        m_blockSize(other.m_blockSize),
+        m_size(std::exchange(other.m_size, 0)),
+        m_needsDestroy(std::exchange(other.m_needsDestroy, false)) {}
+
+  CommandBuffer& operator=(CommandBuffer&& other) {
+    if (this != &other) {
+      reset();
+      m_blocks = std::move(other.m_blocks);
+      m_current = std::exchange(other.m_current, 0);
+      m_last = std::exchange(other.m_last, nullptr);
+      m_blockSize = other.m_blockSize;
+      m_size = std::exchange(other.m_size, 0);
+      m_needsDestroy = std::exchange(other.m_needsDestroy, false);
+    }
+    return *this;
+  }
+
+  ~CommandBuffer() { reset(); }
+
+  ///
+  /// @brief      Appends a callable, which is invoked without arguments on
+  ///             execute().
+  ///
+  /// @param      f     Callable, moved or copied into the buffer.
+  ///
+  template <typename Functor>
+  void push(Functor&& f) {
+    emplace<std::decay_t<Functor>>(std::forward<Functor>(f));
+  }
+
+  ///
+  /// @brief      Constructs a callable of type Functor in the buffer, e.g.
+  ///             one that is neither copyable nor movable.
+  ///
+  /// @param      args  Arguments passed to the constructor.
+  ///
+  template <typename Functor, typename... Args>
+  void emplace(Args&&... args) {
+    static_assert(alignof(Functor) <= kBlockAlignment,
+                  "Callable must not be over-aligned.");
+
+    constexpr std::size_t alignment = alignof(Functor) > alignof(Header)
+                                          ? alignof(Functor)
+                                          : alignof(Header);
+    constexpr std::size_t offset = alignUp(sizeof(Header), alignof(Functor));
+    constexpr std::size_t size =
+        alignUp(offset + sizeof(Functor), alignof(Header));
+
+    // The record only becomes part of the buffer once the callable has been
+    // constructed, so a throwing constructor leaves the buffer unchanged
+    std::byte* record = allocate(size, alignment);
+    new (record + offset) Functor(std::forward<Args>(args)...);
+    new (record) Header{&thunk<Functor>, static_cast<std::uint32_t>(size),
+                        static_cast<std::uint32_t>(offset)};
+    commit(record, size);
+    ++m_size;
+    m_needsDestroy |= !std::is_trivially_destructible_v<Functor>;
+  }
+
+  // Invoke all recorded callables in the order they were pushed
+  void execute() { forEachRecord(Action::Invoke); }
+
+  // Destroy all recorded callables, keeping the memory blocks for reuse
+  void reset() {
+    if (m_needsDestroy) forEachRecord(Action::Destroy);
+    for (std::size_t b = 0; b <= m_current && b < m_blocks.size(); ++b) {
+      m_blocks[b].used = 0;
+    }
+    m_current = 0;
+    m_last = nullptr;
+    m_size = 0;
+    m_needsDestroy = false;
+  }
+
+  // Number of recorded callables
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  // Bytes used by records, including headers and padding
+  std::size_t bytesUsed() const {
+    std::size_t used = 0;
+    for (const Block& block : m_blocks) used += block.used;
+    return used;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  static constexpr std::size_t alignUp(std::size_t n, std::size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+  template <typename Functor>
+  static void thunk(void* capture, Action action) {
+    Functor& f = *std::launder(static_cast<Functor*>(capture));
+    if (action == Action::Invoke) {
+      f();
+    } else {
+      f.~Functor();
+    }
+  }
+
+  // Memory for the next record, moving on to the next block if necessary.
+  // Blocks start at kBlockAlignment, so only the offset needs aligning.
+  std::byte* allocate(std::size_t size, std::size_t alignment) {
+    if (m_current < m_blocks.size()) {
+      const Block& block = m_blocks[m_current];
+      if (block.capacity - block.used < size ||
+          block.capacity - block.used - size <
+              alignUp(block.used, alignment) - block.used) {
+        ++m_current;
+        m_last = nullptr;
+      }
+    }
+    if (m_current == m_blocks.size() || m_blocks[m_current].capacity < size) {
+      const std::size_t capacity = size > m_blockSize ? size : m_blockSize;
+      std::unique_ptr<std::byte[]> data(new std::byte[capacity]);
+      m_blocks.insert(m_blocks.begin() + m_current,
+                      Block{std::move(data), capacity});
+    }
+    Block& block = m_blocks[m_current];
+    return block.data.get() + alignUp(block.used, alignment);
+  }
+
+  // Appends the record returned by allocate(). Alignment padding in front of
+  // it is added to the previous record, so records stay back-to-back.
+  void commit(std::byte* record, std::size_t size) {
+    Block& block = m_blocks[m_current];
+    const std::size_t start = std::size_t(record - block.data.get());
+    if (m_last != nullptr) m_last->size += std::uint32_t(start - block.used);
+    block.used = start + size;
+    m_last = std::launder(reinterpret_cast<Header*>(record));
+  }
+
+  void forEachRecord(Action action) {
+    for (std::size_t b = 0; b <= m_current && b < m_blocks.size(); ++b) {
+      std::byte* cursor = m_blocks[b].data.get();
+      std::byte* const end = cursor + m_blocks[b].used;
+      while (cursor != end) {
+        const Header& header =
+            *std::launder(reinterpret_cast<Header*>(cursor));
+        header.thunk(cursor + header.offset, action);
+        cursor += header.size;
+      }
+    }
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <ibex/Storage.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      A priority queue implemented as an implicit d-ary heap.
+///             It differs from std::priority_queue in the following aspects:
+///             - Every pushed element gets a Handle which stays valid until
+///               the element is popped or erased. Through it the element can
+///               be updated or erased in O(log n).
+///             - A node has D children instead of two. The children of a node
+///               are adjacent, so with D=4 a sift-down compares within one or
+///               two cache lines and the heap is half as deep.
+///             Like std::priority_queue, top() is the largest element under
+///             Compare.
+///
+/// @tparam     T        Element type
+/// @tparam     D        Number of children per node
+/// @tparam     Compare  Strict weak ordering, std::less gives a max-heap
+///
+template <typename T, std::size_t D = 4, typename Compare = std::less<T>>
+class DaryHeap final {
+ public:
+  using Handle = std::uint32_t;
+
+ private:
+  static_assert(D >= 2, "A heap node needs at least two children (D).");
+
+  static constexpr std::uint32_t kInvalid =
+      std::numeric_limits<std::uint32_t>::max();
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::unique_ptr<Storage<T>[]> m_data;  // Elements in heap order
+  std::size_t m_size{0};
+  std::size_t m_capacity{0};
+  std::vector<Handle> m_handles;           // Heap position -> handle
+  std::vector<std::uint32_t> m_positions;  // Handle -> heap position
+  std::vector<Handle> m_freeHandles;
+  Compare m_compare;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  explicit DaryHeap(const Compare& compare = Compare{}) : m_compare(compare) {}
+
+  DaryHeap(DaryHeap&& other)
+      : m_data(std::move(other.m_data)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_capacity(std::exchange(other.m_capacity, 0)),
+        m_handles(std::move(other.m_handles)),
+        m_positions(std::move(other.m_positions)),
+        m_freeHandles(std::move(other.m_freeHandles)),
+        m_compare(std::move(other.m_compare)) {}
+
+  DaryHeap& operator=(DaryHeap&& other) {
+    if (this != &other) {
+      clear();
+      m_data = std::move(other.m_data);
+      m_size = std::exchange(other.m_size, 0);
+      m_capacity = std::exchange(other.m_capacity, 0);
+      m_handles = std::move(other.m_handles);
+      m_positions = std::move(other.m_positions);
+      m_freeHandles = std::move(other.m_freeHandles);
+      m_compare = std::move(other.m_compare);
+    }
+    return *this;
+  }
+
+  ~DaryHeap() { clear(); }
+
+  ///
+  /// @brief      Constructs a new element and moves it to its heap position.
+  ///
+  /// @param      args  Arguments passed to the constructor.
+  ///
+  /// @return     Handle of the new element.
+  ///
+  template <typename... Args>
+  Handle emplace(Args&&... args) {
+    if (m_size == m_capacity) grow(m_capacity == 0 ? 16 : 2 * m_capacity);
+    const Handle handle = allocateHandle();
+    m_data[m_size].create(std::forward<Args>(args)...);
+    place(m_size, handle);
+    ++m_size;
+    siftUp(m_size - 1);
+    return handle;
+  }
+
+  Handle push(const T& value) { return emplace(value); }
+  Handle push(T&& value) { return emplace(std::move(value)); }
+
+  ///
+  /// @brief      Replaces the contents by the elements of [first, last) and
+  ///             restores the heap property bottom-up in O(n).
+  ///
+  /// @return     Handles of the elements, in the order of the input range.
+  ///
+  template <typename InputIt>
+  std::vector<Handle> assign(InputIt first, InputIt last) {
+    clear();
+    m_freeHandles.clear();
+    m_positions.clear();
+    for (; first != last; ++first) {
+      if (m_size == m_capacity) grow(m_capacity == 0 ? 16 : 2 * m_capacity);
+      m_data[m_size].create(*first);
+      m_positions.push_back(0);
+      place(m_size, static_cast<Handle>(m_size));
+      ++m_size;
+    }
+    if (m_size > 1) {
+      for (std::size_t i = (m_size - 2) / D + 1; i-- > 0;) siftDown(i);
+    }
+    std::vector<Handle> handles(m_size);
+    std::iota(handles.begin(), handles.end(), Handle{0});
+    return handles;
+  }
+
+  // Largest element. Calling this on an empty heap is undefined behaviour.
+  const T& top() const { return m_data[0].get(); }
+
+  // Handle of the largest element
+  Handle topHandle() const { return m_handles[0]; }
+
+  // Remove the largest element, its handle becomes invalid
+  void pop() { removeAt(0); }
+
+  // Remove the element with the given handle, the handle becomes invalid
+  void erase(Handle handle) { removeAt(position(handle)); }
+
+  // Access the element with the given handle
+  const T& get(Handle handle) const { return m_data[position(handle)].get(); }
+
+  // Check whether handle refers to an element in the heap
+  bool contains(Handle handle) const {
+    return handle < m_positions.size() && m_positions[handle] != kInvalid;
+  }
+
+  ///
+  /// @brief      Replaces the value of an element and restores its position,
+  ///             sifting in whichever direction is necessary.
+  ///
+  void update(Handle handle, T value) {
+    const std::size_t pos = position(handle);
+    const bool up = m_compare(m_data[pos].get(), value);
+    m_data[pos].get() = std::move(value);
+    up ? siftUp(pos) : siftDown(pos);
+  }
+
+  ///
+  /// @brief      Replaces the value of an element by one that does not compare
+  ///             less than the old value, i.e. moves the element towards top.
+  ///             Only sifts up.
+  ///
+  void increaseKey(Handle handle, T value) {
+    const std::size_t pos = position(handle);
+    m_data[pos].get() = std::move(value);
+    siftUp(pos);
+  }
+
+  ///
+  /// @brief      Replaces the value of an element by one that does not compare
+  ///             greater than the old value, i.e. moves the element away from
+  ///             top. Only sifts down.
+  ///
+  void decreaseKey(Handle handle, T value) {
+    const std::size_t pos = position(handle);
+    m_data[pos].get() = std::move(value);
+    siftDown(pos);
+  }
+
+  // Destroy all elements and invalidate all handles
+  void clear() {
+    for (std::size_t i = 0; i < m_size; ++i) {
+      m_positions[m_handles[i]] = kInvalid;
+      m_freeHandles.push_back(m_handles[i]);
+      m_data[i].destroy();
+    }
+    m_size = 0;
+  }
+
+  // Make sure count elements fit without reallocation
+  void reserve(std::size_t count) {
+    if (count > m_capacity) grow(count);
+  }
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  std::size_t position(Handle handle) const {
+    if (!contains(handle)) throw std::out_of_range("DaryHeap: invalid handle");
+    return m_positions[handle];
+  }
+
+  Handle allocateHandle() {
+    if (!m_freeHandles.empty()) {
+      const Handle handle = m_freeHandles.back();
+      m_freeHandles.pop_back();
+      return handle;
+    }
+    m_positions.push_back(kInvalid);
+    return static_cast<Handle>(m_positions.size() - 1);
+  }
+
+  // Record that the element with handle now lives at pos
+  void place(std::size_t pos, Handle handle) {
+    m_handles[pos] = handle;
+    m_positions[handle] = static_cast<std::uint32_t>(pos);
+  }
+
+  // Remove element at pos, filling the hole with the last element
+  void removeAt(std::size_t pos) {
+    const Handle handle = m_handles[pos];
+    const std::size_t last = m_size - 1;
+    if (pos != last) {
+      m_data[pos].get() = std::move(m_data[last].get());
+      place(pos, m_handles[last]);
+    }
+    m_data[last].destroy();
+    m_positions[handle] = kInvalid;
+    m_freeHandles.push_back(handle);
+    m_size = last;
+    if (pos != last) {
+      siftUp(pos);
+      siftDown(pos);
+    }
+  }
+
+  // Move the element at pos up until its parent is not smaller
+  void siftUp(std::size_t pos) {
+    if (pos == 0) return;
+    T value = std::move(m_data[pos].get());
+    const Handle handle = m_handles[pos];
+    while (pos > 0) {
+      const std::size_t parent = (pos - 1) / D;
+      if (!m_compare(m_data[parent].get(), value)) break;
+      m_data[pos].get() = std::move(m_data[parent].get());
+      place(pos, m_handles[parent]);
+      pos = parent;
+    }
+    m_data[pos].get() = std::move(value);
+    place(pos, handle);
+  }
+
+  // Move the element at pos down until no child is larger
+  void siftDown(std::size_t pos) {
+    if (pos * D + 1 >= m_size) return;
+    T value = std::move(m_data[pos].get());
+    const Handle handle = m_handles[pos];
+    for (;;) {
+      const std::size_t first = pos * D + 1;
+      if (first >= m_size) break;
+      const std::size_t end = first + D < m_size ? first + D : m_size;
+      std::size_t best = first;
+      for (std::size_t c = first + 1; c < end; ++c) {
+        if (m_compare(m_data[best].get(), m_data[c].get())) best = c;
+      }
+      if (!m_compare(value, m_data[best].get())) break;
+      m_data[pos].get() = std::move(m_data[best].get());
+      place(pos, m_handles[best]);
+      pos = best;
+    }
+    m_data[pos].get() = std::move(value);
+    place(pos, handle);
+  }
+
+  // Relocate all elements into a buffer for capacity elements
+  void grow(std::size_t capacity) {
+    std::unique_ptr<Storage<T>[]> data(new Storage<T>[capacity]);
+    if constexpr (is_trivially_relocatable_v<T>) {
+      if (m_size > 0) {
+        std::memcpy(static_cast<void*>(data.get()), m_data.get(),
+                    m_size * sizeof(Storage<T>));
+      }
+    } else {
+      for (std::size_t i = 0; i < m_size; ++i) {
+        data[i].create(std::move(m_data[i].get()));
+        m_data[i].destroy();
+      }
+    }
+    m_data = std::move(data);
+    m_capacity = capacity;
+    m_handles.resize(capacity);
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <ibex/Function.h>
+#include <ibex/Hash.h>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace ibex {
+
+namespace detail {
+
+constexpr std::uint64_t fnv1a(std::string_view key) {
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+constexpr std::size_t nextPowerOfTwo(std::size_t n) {
+  std::size_t result = 1;
+  while (result < n) result <<= 1;
+  return result;
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// PerfectHash
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      A perfect hash over a fixed set of string keys, built at
+///             compile time with hash-and-displace: keys are grouped into
+///             buckets by their hash, and every bucket gets a seed that maps
+///             its keys to free slots. A lookup hashes the key once, mixes in
+///             the seed of its bucket and does one string compare.
+///             Declare it as a static constexpr variable to place the table
+///             in read-only data.
+///
+/// @tparam     N     Number of keys
+///
+template <std::size_t N>
+class PerfectHash {
+ private:
+  static constexpr std::size_t kSlots = detail::nextPowerOfTwo(N + N / 4 + 1);
+  static constexpr std::size_t kBuckets = kSlots / 4 > 0 ? kSlots / 4 : 1;
+  static constexpr std::uint32_t kMaxSeed = 1u << 20;
+
+  std::array<std::string_view, kSlots> m_keys{};
+  std::array<std::size_t, kSlots> m_indices{};  // N marks empty slots
+  std::array<std::uint32_t, kBuckets> m_seeds{};
+
+  static constexpr std::size_t bucketOf(std::uint64_t hash) {
+    return (hash >> 32) & (kBuckets - 1);
+  }
+
+  static constexpr std::size_t slotOf(std::uint64_t hash, std::uint32_t seed) {
+    return hashInteger(hash ^ (seed * 0x9e3779b97f4a7c15ull)) & (kSlots - 1);
+  }
+
+ public:
+  ///
+  /// @brief      Builds the table. Throws on duplicate keys, which fails
+  ///             compilation when evaluated in a constant expression.
+  ///
+  /// @param      keys  Keys, find() returns the position of a key in here.
+  ///
+  constexpr explicit PerfectHash(const std::string_view (&keys)[N]) {
+    for (std::size_t& index : m_indices) index = N;
+
+    std::array<std::uint64_t, N> hashes{};
+    std::array<std::size_t, kBuckets> bucketSizes{};
+    for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t j = 0; j < i; ++j) {
+        if (keys[i] == keys[j]) throw std::logic_error("Duplicate key.");
+      }
+      hashes[i] = detail::fnv1a(keys[i]);
+      ++bucketSizes[bucketOf(hashes[i])];
+    }
+
+    // Place large buckets first while there are many free slots
+    std::array<std::size_t, kBuckets> order{};
+    for (std::size_t b = 0; b < kBuckets; ++b) order[b] = b;
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+      for (std::size_t c = b + 1; c < kBuckets; ++c) {
+        if (bucketSizes[order[c]] > bucketSizes[order[b]]) {
+          const std::size_t tmp = order[b];
+          order[b] = order[c];
+          order[c] = tmp;
+        }
+      }
+    }
+
+    std::array<bool, kSlots> occupied{};
+    for (std::size_t b : order) {
+      if (bucketSizes[b] == 0) break;
+      std::uint32_t seed = 0;
+      for (;; ++seed) {
+        if (seed == kMaxSeed) throw std::logic_error("No seed found.");
+        std::array<bool, kSlots> taken = occupied;
+        bool fits = true;
+        for (std::size_t i = 0; i < N && fits; ++i) {
+          if (bucketOf(hashes[i]) != b) continue;
+          const std::size_t slot = slotOf(hashes[i], seed);
+          fits = !taken[slot];
+          taken[slot] = true;
+        }
+        if (fits) {
+          occupied = taken;
+          break;
+        }
+      }
+      m_seeds[b] = seed;
+      for (std::size_t i = 0; i < N; ++i) {
+        if (bucketOf(hashes[i]) != b) continue;
+        const std::size_t slot = slotOf(hashes[i], seed);
+        m_keys[slot] = keys[i];
+        m_indices[slot] = i;
+      }
+    }
+  }
+
+  ///
+  /// @brief      Looks up a key.
+  ///
+  /// @return     Position of key in the constructor argument, N if unknown.
+  ///
+  constexpr std::size_t find(std::string_view key) const {
+    const std::uint64_t hash = detail::fnv1a(key);
+    const std::size_t slot = slotOf(hash, m_seeds[bucketOf(hash)]);
+    return m_keys[slot] == key ? m_indices[slot] : N;
+  }
+
+  static constexpr std::size_t size() { return N; }
+};
+
+template <std::size_t N>
+PerfectHash(const std::string_view (&)[N]) -> PerfectHash<N>;
+
+// ---------------------------------------------------------------------------
+// DispatchTable
+// ---------------------------------------------------------------------------
+
+template <typename, std::size_t, std::size_t>
+class DispatchTable;
+
+///
+/// @brief      Maps a fixed set of string keys to ibex::Function handlers.
+///             Keys are resolved through a PerfectHash, so dispatching is one
+///             hash, one compare and one indirect call.
+///
+/// @tparam     Size  Maximal handler size in bytes
+/// @tparam     N     Number of keys
+/// @tparam     R     Handler return type
+/// @tparam     Args  Handler argument types
+///
+template <std::size_t Size, std::size_t N, typename R, typename... Args>
+class DispatchTable<R(Args...), Size, N> final {
+ public:
+  using Handler = Function<R(Args...), Size>;
+
+ private:
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  const PerfectHash<N>& m_keys;
+  std::array<Handler, N> m_handlers;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Creates a table without any handlers.
+  ///
+  /// @param      keys  Key set, usually a static constexpr PerfectHash. It
+  ///                   must outlive the table.
+  ///
+  explicit DispatchTable(const PerfectHash<N>& keys) : m_keys(keys) {}
+
+  // Install handler for key. Returns false if key is not in the key set.
+  bool set(std::string_view key, Handler handler) {
+    const std::size_t index = m_keys.find(key);
+    if (index == N) return false;
+    m_handlers[index] = std::move(handler);
+    return true;
+  }
+
+  // Handler for key, or nullptr if key is not in the key set
+  Handler* find(std::string_view key) {
+    const std::size_t index = m_keys.find(key);
+    return index == N ? nullptr : &m_handlers[index];
+  }
+
+  // Invoke the handler for key. Throws if key is unknown or has no handler.
+  R operator()(std::string_view key, Args... args) {
+    const std::size_t index = m_keys.find(key);
+    if (index == N) throw std::out_of_range("DispatchTable: unknown key");
+    return m_handlers[index](std::forward<Args>(args)...);
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <ibex/Function.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      A single-threaded event loop over epoll. Handlers are called
+///             with the epoll event mask of their file descriptor.
+///             Register with EPOLLET for edge-triggered notification; the
+///             handler must then consume everything available, e.g. read
+///             until EAGAIN, or it will not be called again.
+///             Handlers may add and remove descriptors, including their own.
+///             All functions except stop() must be called from the thread
+///             that runs the loop.
+///
+class EventLoop final {
+ public:
+  using Handler = Function<void(std::uint32_t), 64>;
+
+ private:
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  int m_epoll{-1};
+  int m_wakeup{-1};
+  // Handlers are not moved while they run, even if they remove themselves
+  std::unordered_map<int, std::unique_ptr<Handler>> m_handlers;
+  std::vector<std::unique_ptr<Handler>> m_removed;  // Destroyed after dispatch
+  std::vector<epoll_event> m_events;
+  std::atomic<bool> m_stopped{false};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @param      maxEvents  Events fetched by one epoll_wait().
+  ///
+  explicit EventLoop(std::size_t maxEvents = 64) : m_events(maxEvents) {
+    m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0) fail("epoll_create1");
+    m_wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeup < 0) {
+      const int error = errno;
+      ::close(m_epoll);
+      errno = error;
+      fail("eventfd");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeup;
+    if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event) != 0) {
+      const int error = errno;
+      ::close(m_wakeup);
+      ::close(m_epoll);
+      errno = error;
+      fail("epoll_ctl");
+    }
+  }
+
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  ~EventLoop() {
+    ::close(m_wakeup);
+    ::close(m_epoll);
+  }
+
+  ///
+  /// @brief      Calls handler whenever fd is ready for events, an epoll mask
+  ///             such as EPOLLIN | EPOLLET. Throws std::system_error if fd
+  ///             cannot be watched, e.g. because it already is.
+  ///
+  void add(int fd, std::uint32_t events, Handler handler) {
+    control(EPOLL_CTL_ADD, fd, events);
+    m_handlers[fd] = std::make_unique<Handler>(std::move(handler));
+  }
+
+  // Change the events fd is watched for
+  void modify(int fd, std::uint32_t events) {
+    control(EPOLL_CTL_MOD, fd, events);
+  }
+
+  // Stop watching fd; call before closing it
+  void remove(int fd) {
+    const auto handler = m_handlers.find(fd);
+    if (handler == m_handlers.end()) return;
+    ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    m_removed.push_back(std::move(handler->second));
+    m_handlers.erase(handler);
+  }
+
+  std::size_t size() const { return m_handlers.size(); }
+
+  ///
+  /// @brief      Waits for events once and calls the handlers of the ready
+  ///             descriptors.
+  ///
+  /// @param      timeout  Milliseconds to wait, -1 to wait until an event
+  ///                      arrives or stop() is called.
+  ///
+  /// @return     Number of handlers called.
+  ///
+  std::size_t runOnce(int timeout = -1) {
+    const int count = ::epoll_wait(m_epoll, m_events.data(),
+                                   int(m_events.size()), timeout);
+    if (count < 0) {
+      if (errno == EINTR) return 0;
+      fail("epoll_wait");
+    }
+    std::size_t called = 0;
+    for (int i = 0; i < count; ++i) {
+      const int fd = m_events[i].data.fd;
+      if (fd == m_wakeup) {
+        std::uint64_t value;
+        while (::read(m_wakeup, &value, sizeof(value)) > 0) {
+        }
+        continue;
+      }
+      // Skip descriptors removed by an earlier handler of this batch
+      const auto handler = m_handlers.find(fd);
+      if (handler == m_handlers.end()) continue;
+      (*handler->second)(std::uint32_t(m_events[i].events));
+      ++called;
+    }
+    m_removed.clear();
+    return called;
+  }
+
+  // Run until stop() is called
+  void run() {
+    while (!m_stopped) runOnce();
+    m_stopped = false;
+  }
+
+  // Make run() return; may be called from any thread
+  void stop() {
+    m_stopped = true;
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto written =
+        ::write(m_wakeup, &one, sizeof(one));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(),
+                            "EventLoop: " + what);
+  }
+
+  void control(int operation, int fd, std::uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (::epoll_ctl(m_epoll, operation, fd, &event) != 0) {
+      fail("epoll_ctl");
+    }
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,671 @@
+#pragma once
+
+#include <ibex/Function.h>
+#include <ibex/PageMemory.h>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      Outcome of a file operation: the number of bytes transferred,
+///             which may be short like for pread(), or a negated errno.
+///
+struct IoResult {
+  std::int64_t value;
+
+  bool ok() const { return value >= 0; }
+  std::size_t bytes() const { return ok() ? std::size_t(value) : 0; }
+
+  std::error_code error() const {
+    return ok() ? std::error_code()
+                : std::error_code(int(-value), std::generic_category());
+  }
+};
+
+enum class IoBackend {
+  Auto,        // io_uring if the kernel allows it, else ThreadPool
+  IoUring,     // io_uring, throws if unavailable
+  ThreadPool,  // Blocking pread/pwrite on dedicated threads
+};
+
+struct FileIoOptions {
+  IoBackend backend{IoBackend::Auto};
+  unsigned queueDepth{256};        // io_uring submission queue entries
+  unsigned threads{4};             // Threads of the ThreadPool backend
+  std::size_t bufferCount{0};      // Registered buffers, see readFixed()
+  std::size_t bufferSize{65536};   // Bytes per registered buffer
+};
+
+namespace detail {
+
+// Linux transfers at most this many bytes per read or write
+inline constexpr std::size_t kMaxIoBytes = 0x7ffff000;
+
+enum class IoOperation : std::uint8_t { Read, Write, ReadFixed, WriteFixed,
+                                        Fsync };
+
+struct IoRequest {
+  IoOperation operation;
+  int file;
+  void* buffer;
+  std::uint32_t size;
+  std::uint16_t bufferIndex;
+  std::uint64_t offset;
+  std::uint64_t id;
+};
+
+struct IoCompletion {
+  std::uint64_t id;
+  std::int64_t result;
+};
+
+// Executes a request with blocking system calls
+inline std::int64_t executeIo(const IoRequest& request) {
+  for (;;) {
+    ssize_t result = 0;
+    switch (request.operation) {
+      case IoOperation::Read:
+      case IoOperation::ReadFixed:
+        result = ::pread(request.file, request.buffer, request.size,
+                         off_t(request.offset));
+        break;
+      case IoOperation::Write:
+      case IoOperation::WriteFixed:
+        result = ::pwrite(request.file, request.buffer, request.size,
+                          off_t(request.offset));
+        break;
+      case IoOperation::Fsync:
+        result = ::fsync(request.file);
+        break;
+    }
+    if (result >= 0) return result;
+    if (errno != EINTR) return -errno;
+  }
+}
+
+///
+/// @brief      Where requests are executed. queue() only records a request,
+///             submit() hands all recorded requests over in one batch.
+///
+class IoEngine {
+ public:
+  virtual ~IoEngine() = default;
+
+  virtual IoBackend backend() const = 0;
+
+  // Requests that may be in flight at the same time
+  virtual std::size_t capacity() const = 0;
+
+  // Record a request, false if the queue is full and must be submitted first
+  virtual bool queue(const IoRequest& request) = 0;
+
+  virtual void submit() = 0;
+
+  // Submit, then append completions to out, blocking until there are at least
+  // minimum of them
+  virtual void reap(std::vector<IoCompletion>& out, std::size_t minimum) = 0;
+
+  // Register buffers for ReadFixed and WriteFixed, false if not supported
+  virtual bool registerBuffers(const iovec*, std::size_t) { return false; }
+};
+
+// ---------------------------------------------------------------------------
+// IoUring
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      An io_uring instance driven by raw system calls. Throws
+///             std::system_error if the kernel does not support io_uring,
+///             forbids it, e.g. by a seccomp filter, or predates
+///             IORING_OP_READ (Linux 5.6).
+///
+class IoUring final : public IoEngine {
+ private:
+  int m_ring{-1};
+  void* m_sqRing{MAP_FAILED};
+  std::size_t m_sqRingBytes{0};
+  void* m_cqRing{MAP_FAILED};
+  std::size_t m_cqRingBytes{0};
+  io_uring_sqe* m_sqes{nullptr};
+  std::size_t m_sqesBytes{0};
+
+  unsigned* m_sqHead{nullptr};
+  unsigned* m_sqTail{nullptr};
+  unsigned* m_sqArray{nullptr};
+  unsigned m_sqMask{0};
+  unsigned m_sqEntries{0};
+  unsigned* m_cqHead{nullptr};
+  unsigned* m_cqTail{nullptr};
+  io_uring_cqe* m_cqes{nullptr};
+  unsigned m_cqMask{0};
+  unsigned m_cqEntries{0};
+
+  unsigned m_unsubmitted{0};
+  bool m_fixedBuffers{false};
+
+ public:
+  explicit IoUring(unsigned entries) {
+    io_uring_params params{};
+    m_ring = int(::syscall(__NR_io_uring_setup, entries, &params));
+    if (m_ring < 0) fail("io_uring_setup");
+    try {
+      // Added in the same release as IORING_OP_READ and IORING_OP_WRITE
+      if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        errno = ENOSYS;
+        fail("io_uring lacks IORING_OP_READ");
+      }
+      map(params);
+    } catch (...) {
+      release();
+      throw;
+    }
+  }
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  ~IoUring() override { release(); }
+
+  IoBackend backend() const override { return IoBackend::IoUring; }
+  std::size_t capacity() const override { return m_cqEntries; }
+
+  bool queue(const IoRequest& request) override {
+    const unsigned tail = *m_sqTail;
+    if (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) == m_sqEntries) {
+      return false;
+    }
+    const unsigned index = tail & m_sqMask;
+    io_uring_sqe& sqe = m_sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    switch (request.operation) {
+      case IoOperation::Read:
+        sqe.opcode = IORING_OP_READ;
+        break;
+      case IoOperation::Write:
+        sqe.opcode = IORING_OP_WRITE;
+        break;
+      case IoOperation::ReadFixed:
+        sqe.opcode = m_fixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        break;
+      case IoOperation::WriteFixed:
+        sqe.opcode = m_fixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        break;
+      case IoOperation::Fsync:
+        sqe.opcode = IORING_OP_FSYNC;
+        break;
+    }
+    sqe.fd = request.file;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(request.buffer);
+    sqe.len = request.size;
+    sqe.off = request.offset;
+    sqe.buf_index = request.bufferIndex;
+    sqe.user_data = request.id;
+    m_sqArray[index] = index;
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++m_unsubmitted;
+    return true;
+  }
+
+  void submit() override {
+    if (m_unsubmitted > 0) enter(0);
+  }
+
+  void reap(std::vector<IoCompletion>& out, std::size_t minimum) override {
+    submit();
+    if (ready() < minimum) enter(unsigned(minimum));
+    unsigned head = *m_cqHead;
+    const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+      out.push_back(IoCompletion{cqe.user_data, cqe.res});
+    }
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+  }
+
+  bool registerBuffers(const iovec* buffers, std::size_t count) override {
+    m_fixedBuffers = ::syscall(__NR_io_uring_register, m_ring,
+                               IORING_REGISTER_BUFFERS, buffers,
+                               unsigned(count)) == 0;
+    return m_fixedBuffers;
+  }
+
+ private:
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(),
+                            "IoUring: " + what);
+  }
+
+  static void* mapRing(int ring, std::size_t bytes, off_t offset) {
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring, offset);
+    if (mapping == MAP_FAILED) fail("mmap");
+    return mapping;
+  }
+
+  void map(const io_uring_params& params) {
+    m_sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingBytes =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      if (m_cqRingBytes > m_sqRingBytes) m_sqRingBytes = m_cqRingBytes;
+      m_sqRing = mapRing(m_ring, m_sqRingBytes, IORING_OFF_SQ_RING);
+    } else {
+      m_sqRing = mapRing(m_ring, m_sqRingBytes, IORING_OFF_SQ_RING);
+      m_cqRing = mapRing(m_ring, m_cqRingBytes, IORING_OFF_CQ_RING);
+    }
+    m_sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = static_cast<io_uring_sqe*>(
+        mapRing(m_ring, m_sqesBytes, IORING_OFF_SQES));
+
+    auto* sq = static_cast<char*>(m_sqRing);
+    auto* cq = static_cast<char*>(m_cqRing == MAP_FAILED ? m_sqRing
+                                                         : m_cqRing);
+    m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sqEntries = params.sq_entries;
+    m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqEntries = params.cq_entries;
+  }
+
+  unsigned ready() const {
+    return __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE) - *m_cqHead;
+  }
+
+  // Submit all queued requests and wait for minimum completions
+  void enter(unsigned minimum) {
+    for (;;) {
+      const long submitted = ::syscall(
+          __NR_io_uring_enter, m_ring, m_unsubmitted, minimum,
+          minimum > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+      if (submitted >= 0) {
+        m_unsubmitted -= unsigned(submitted);
+        if (m_unsubmitted == 0 || minimum > 0) return;
+      } else if (errno != EINTR && errno != EAGAIN) {
+        fail("io_uring_enter");
+      }
+    }
+  }
+
+  void release() {
+    if (m_sqes != nullptr) ::munmap(m_sqes, m_sqesBytes);
+    if (m_cqRing != MAP_FAILED) ::munmap(m_cqRing, m_cqRingBytes);
+    if (m_sqRing != MAP_FAILED) ::munmap(m_sqRing, m_sqRingBytes);
+    if (m_ring >= 0) ::close(m_ring);
+    m_sqes = nullptr;
+    m_cqRing = m_sqRing = MAP_FAILED;
+    m_ring = -1;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// IoThreadPool
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Executes requests with blocking system calls on a set of
+///             threads, for kernels and containers without io_uring.
+///
+class IoThreadPool final : public IoEngine {
+ private:
+  std::vector<IoRequest> m_batch;  // Queued, not yet submitted
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::condition_variable m_done;
+  std::deque<IoRequest> m_requests;
+  std::vector<IoCompletion> m_completions;
+  bool m_stop{false};
+  std::vector<std::thread> m_threads;
+
+ public:
+  explicit IoThreadPool(unsigned threads) {
+    if (threads == 0) threads = 1;
+    for (unsigned t = 0; t < threads; ++t) {
+      m_threads.emplace_back([this] { run(); });
+    }
+  }
+
+  ~IoThreadPool() override {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_work.notify_all();
+    for (auto& thread : m_threads) thread.join();
+  }
+
+  IoBackend backend() const override { return IoBackend::ThreadPool; }
+  std::size_t capacity() const override { return SIZE_MAX; }
+
+  bool queue(const IoRequest& request) override {
+    m_batch.push_back(request);
+    return true;
+  }
+
+  void submit() override {
+    if (m_batch.empty()) return;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_requests.insert(m_requests.end(), m_batch.begin(), m_batch.end());
+    }
+    if (m_batch.size() == 1) {
+      m_work.notify_one();
+    } else {
+      m_work.notify_all();
+    }
+    m_batch.clear();
+  }
+
+  void reap(std::vector<IoCompletion>& out, std::size_t minimum) override {
+    submit();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&] { return m_completions.size() >= minimum; });
+    out.insert(out.end(), m_completions.begin(), m_completions.end());
+    m_completions.clear();
+  }
+
+ private:
+  void run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+      m_work.wait(lock, [&] { return m_stop || !m_requests.empty(); });
+      if (m_requests.empty()) return;
+      const IoRequest request = m_requests.front();
+      m_requests.pop_front();
+      lock.unlock();
+      const IoCompletion completion{request.id, executeIo(request)};
+      lock.lock();
+      m_completions.push_back(completion);
+      m_done.notify_one();
+    }
+  }
+};
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// FileIoService
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Asynchronous file reads and writes whose completions are
+///             delivered to callbacks, so worker threads never block on the
+///             disk. Uses io_uring when the kernel allows it, and a pool of
+///             threads doing blocking I/O otherwise, e.g. in containers whose
+///             seccomp profile forbids io_uring. Both behave the same.
+///
+///             Requests are queued and handed to the kernel in one batch by
+///             submit(), poll(), wait() or drain(); callbacks run on the
+///             calling thread inside poll(), wait() and drain(), and may
+///             start new requests. The service is used by one thread, like an
+///             event loop. The buffer of a request must stay valid until its
+///             callback runs. Destroying the service waits for requests in
+///             flight without calling their callbacks.
+///
+/// @tparam     CallbackSize  Maximal size of a callback, see Function
+///
+template <std::size_t CallbackSize = 64>
+class FileIoService final {
+ public:
+  using Callback = Function<void(IoResult), CallbackSize>;
+
+ private:
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  // Declared first, so it is unmapped only after the engine that registered
+  // it has been destroyed and no request uses it anymore
+  PageMemory m_buffers;
+  std::unique_ptr<detail::IoEngine> m_engine;
+  std::size_t m_bufferCount{0};
+  std::size_t m_bufferSize{0};
+  bool m_fixedBuffers{false};
+  std::vector<Callback> m_callbacks;  // By request id
+  std::vector<std::uint32_t> m_freeIds;
+  std::vector<detail::IoCompletion> m_completed;  // Reaped, not yet run
+  std::size_t m_inFlight{0};                      // Queued, not yet reaped
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Sets up the backend chosen by options. Throws
+  ///             std::system_error if IoBackend::IoUring was requested and is
+  ///             not available.
+  ///
+  explicit FileIoService(FileIoOptions options = {}) {
+    if (options.backend != IoBackend::ThreadPool) {
+      try {
+        m_engine = std::make_unique<detail::IoUring>(options.queueDepth);
+      } catch (const std::system_error&) {
+        if (options.backend == IoBackend::IoUring) throw;
+      }
+    }
+    if (!m_engine) {
+      m_engine = std::make_unique<detail::IoThreadPool>(options.threads);
+    }
+    if (options.bufferCount > 0) setUpBuffers(options);
+  }
+
+  FileIoService(const FileIoService&) = delete;
+  FileIoService& operator=(const FileIoService&) = delete;
+
+  ~FileIoService() {
+    try {
+      while (m_inFlight > 0) reap(1);
+    } catch (...) {
+      // The engine is destroyed next, before m_buffers, which cancels or
+      // waits for what is left
+    }
+  }
+
+  IoBackend backend() const { return m_engine->backend(); }
+
+  // Requests whose callbacks have not run yet
+  std::size_t pending() const { return m_inFlight + m_completed.size(); }
+
+  ///
+  /// @brief      Reads up to size bytes at offset into buffer.
+  ///
+  void read(int file, void* buffer, std::size_t size, std::uint64_t offset,
+            Callback callback) {
+    enqueue(detail::IoOperation::Read, file, buffer, size, 0, offset,
+            std::move(callback));
+  }
+
+  // Writes up to size bytes of buffer at offset
+  void write(int file, const void* buffer, std::size_t size,
+             std::uint64_t offset, Callback callback) {
+    enqueue(detail::IoOperation::Write, file, const_cast<void*>(buffer), size,
+            0, offset, std::move(callback));
+  }
+
+  void fsync(int file, Callback callback) {
+    enqueue(detail::IoOperation::Fsync, file, nullptr, 0, 0, 0,
+            std::move(callback));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Registered Buffers
+  // ---------------------------------------------------------------------------
+
+  std::size_t bufferCount() const { return m_bufferCount; }
+  std::size_t bufferSize() const { return m_bufferSize; }
+
+  // Whether the kernel has the buffers pinned; if not, e.g. because of
+  // RLIMIT_MEMLOCK, fixed requests fall back to plain reads and writes
+  bool fixedBuffers() const { return m_fixedBuffers; }
+
+  std::byte* buffer(std::size_t index) {
+    checkBuffer(index, 0);
+    return static_cast<std::byte*>(m_buffers.data()) + index * m_bufferSize;
+  }
+
+  ///
+  /// @brief      Reads into registered buffer index, which saves the kernel
+  ///             from mapping the pages of the buffer for every request.
+  ///             Throws std::out_of_range for an invalid index or size.
+  ///
+  void readFixed(int file, std::size_t index, std::size_t size,
+                 std::uint64_t offset, Callback callback) {
+    checkBuffer(index, size);
+    enqueue(detail::IoOperation::ReadFixed, file, buffer(index), size,
+            std::uint16_t(index), offset, std::move(callback));
+  }
+
+  void writeFixed(int file, std::size_t index, std::size_t size,
+                  std::uint64_t offset, Callback callback) {
+    checkBuffer(index, size);
+    enqueue(detail::IoOperation::WriteFixed, file, buffer(index), size,
+            std::uint16_t(index), offset, std::move(callback));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Completion
+  // ---------------------------------------------------------------------------
+
+  // Hand all queued requests to the backend in one batch
+  void submit() { m_engine->submit(); }
+
+  ///
+  /// @brief      Submits queued requests and runs the callbacks of completed
+  ///             ones, without blocking.
+  ///
+  /// @return     Number of callbacks run.
+  ///
+  std::size_t poll() {
+    reap(0);
+    return runCompleted();
+  }
+
+  ///
+  /// @brief      Submits queued requests and blocks until at least minimum
+  ///             of them, or all pending ones, have completed, then runs the
+  ///             callbacks of all completed requests.
+  ///
+  /// @return     Number of callbacks run.
+  ///
+  std::size_t wait(std::size_t minimum = 1) {
+    const std::size_t missing =
+        minimum > m_completed.size() ? minimum - m_completed.size() : 0;
+    reap(missing < m_inFlight ? missing : m_inFlight);
+    return runCompleted();
+  }
+
+  // Run until no requests are pending, including ones started by callbacks
+  void drain() {
+    while (pending() > 0) wait(1);
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  void setUpBuffers(const FileIoOptions& options) {
+    if (options.bufferCount > UINT16_MAX) {
+      throw std::invalid_argument("FileIoService: too many buffers");
+    }
+    const std::size_t page = PageMemory::pageSize();
+    m_bufferSize = (options.bufferSize + page - 1) / page * page;
+    m_bufferCount = options.bufferCount;
+    m_buffers = PageMemory(m_bufferCount * m_bufferSize);
+    std::vector<iovec> buffers(m_bufferCount);
+    for (std::size_t i = 0; i < m_bufferCount; ++i) {
+      buffers[i].iov_base =
+          static_cast<std::byte*>(m_buffers.data()) + i * m_bufferSize;
+      buffers[i].iov_len = m_bufferSize;
+    }
+    m_fixedBuffers = m_engine->registerBuffers(buffers.data(), m_bufferCount);
+  }
+
+  void checkBuffer(std::size_t index, std::size_t size) const {
+    if (index >= m_bufferCount || size > m_bufferSize) {
+      throw std::out_of_range("FileIoService: invalid registered buffer");
+    }
+  }
+
+  void enqueue(detail::IoOperation operation, int file, void* buffer,
+               std::size_t size, std::uint16_t bufferIndex,
+               std::uint64_t offset, Callback&& callback) {
+    if (m_inFlight == m_engine->capacity()) reap(1);
+
+    std::uint32_t id;
+    if (m_freeIds.empty()) {
+      id = std::uint32_t(m_callbacks.size());
+      m_callbacks.push_back(std::move(callback));
+    } else {
+      id = m_freeIds.back();
+      m_freeIds.pop_back();
+      m_callbacks[id] = std::move(callback);
+    }
+
+    const detail::IoRequest request{
+        operation,
+        file,
+        buffer,
+        std::uint32_t(size < detail::kMaxIoBytes ? size : detail::kMaxIoBytes),
+        bufferIndex,
+        offset,
+        id};
+    while (!m_engine->queue(request)) m_engine->submit();
+    ++m_inFlight;
+  }
+
+  void reap(std::size_t minimum) {
+    const std::size_t before = m_completed.size();
+    m_engine->reap(m_completed, minimum);
+    m_inFlight -= m_completed.size() - before;
+  }
+
+  // Callbacks may call wait() themselves, so run from a local list
+  std::size_t runCompleted() {
+    std::vector<detail::IoCompletion> running;
+    running.swap(m_completed);
+    std::size_t i = 0;
+    try {
+      for (; i < running.size(); ++i) {
+        const auto id = std::uint32_t(running[i].id);
+        Callback callback = std::move(m_callbacks[id]);
+        m_freeIds.push_back(id);
+        callback(IoResult{running[i].result});
+      }
+    } catch (...) {
+      // Keep the completions after the throwing callback for the next run
+      m_completed.insert(m_completed.begin(), running.begin() + i + 1,
+                         running.end());
+      throw;
+    }
+    if (m_completed.empty()) {
+      running.clear();
+      m_completed.swap(running);  // Keep the capacity
+    }
+    return i;
+  }
+};
+
+}  // namespace ibex
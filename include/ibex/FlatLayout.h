@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+// ---------------------------------------------------------------------------
+// LittleEndian
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      A scalar stored in little-endian byte order with its natural
+///             alignment. Use it for every multi-byte field of a flat layout;
+///             on little-endian hosts reading and writing is a plain copy.
+///
+/// @tparam     T     Integer, floating point or enum type
+///
+template <typename T>
+class LittleEndian final {
+ private:
+  static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>,
+                "LittleEndian stores scalars only (T).");
+
+  T m_value{};
+
+ public:
+  LittleEndian() = default;
+  LittleEndian(T value) { set(value); }
+
+  LittleEndian& operator=(T value) {
+    set(value);
+    return *this;
+  }
+
+  T get() const { return convert(m_value); }
+  operator T() const { return get(); }
+  void set(T value) { m_value = convert(value); }
+
+ private:
+  // Converts between host and little-endian byte order, in either direction
+  static T convert(T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (std::size_t i = 0; i < sizeof(T) / 2; ++i) {
+      const unsigned char byte = bytes[i];
+      bytes[i] = bytes[sizeof(T) - 1 - i];
+      bytes[sizeof(T) - 1 - i] = byte;
+    }
+    std::memcpy(&value, bytes, sizeof(T));
+#endif
+    return value;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Offsets
+// ---------------------------------------------------------------------------
+
+// Tag for an array of T in a flat layout: a 32-bit count followed by the
+// elements, at their alignment
+template <typename T>
+struct FlatVector;
+
+// Tag for a string in a flat layout: a 32-bit size followed by the characters
+using FlatString = FlatVector<char>;
+
+///
+/// @brief      Refers to a T elsewhere in the same flat buffer by its position
+///             from the start of the buffer. A position of 0 means null.
+///             Offsets are resolved, and bounds checked, by FlatView.
+///
+template <typename T>
+struct Offset {
+  LittleEndian<std::uint32_t> position;
+
+  explicit operator bool() const { return position.get() != 0; }
+};
+
+///
+/// @brief      A bounds checked view of the elements of a FlatVector, pointing
+///             into the buffer.
+///
+template <typename T>
+class FlatSpan final {
+ private:
+  const T* m_data{nullptr};
+  std::size_t m_size{0};
+
+ public:
+  FlatSpan() = default;
+  FlatSpan(const T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+  const T* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  const T* begin() const { return m_data; }
+  const T* end() const { return m_data + m_size; }
+
+  const T& operator[](std::size_t index) const { return m_data[index]; }
+
+  const T& at(std::size_t index) const {
+    if (index >= m_size) throw std::out_of_range("FlatSpan: index");
+    return m_data[index];
+  }
+};
+
+namespace detail {
+
+// Start of every flat buffer
+struct FlatHeader {
+  LittleEndian<std::uint32_t> magic;
+  LittleEndian<std::uint32_t> size;  // Bytes of the whole buffer
+  LittleEndian<std::uint32_t> root;  // Position of the root object
+  LittleEndian<std::uint32_t> reserved;
+};
+
+inline constexpr std::uint32_t kFlatMagic = 0x54414c46;  // "FLAT"
+inline constexpr std::size_t kFlatAlignment = 16;
+
+// Offset from a vector's count to its first element
+template <typename T>
+constexpr std::size_t flatVectorHeader() {
+  return alignof(T) > sizeof(std::uint32_t) ? alignof(T)
+                                            : sizeof(std::uint32_t);
+}
+
+template <typename T>
+constexpr void checkFlatType() {
+  static_assert(std::is_trivially_copyable_v<T> &&
+                    std::is_standard_layout_v<T>,
+                "Flat layouts store trivially copyable standard layout "
+                "types only (T).");
+  static_assert(alignof(T) <= kFlatAlignment,
+                "Flat layouts support alignment up to 16 bytes (T).");
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// FlatBuilder
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Writes a flat layout: objects are appended to one buffer at
+///             their alignment, and refer to each other by Offset. Children
+///             are created first and their offsets stored in the parent,
+///             finish() appends the root.
+///             The schema is a C++ struct that is trivially copyable and
+///             stores multi-byte scalars as LittleEndian, arrays and strings
+///             as Offset<FlatVector<T>> and Offset<FlatString>.
+///
+class FlatBuilder final {
+ private:
+  std::vector<std::byte> m_buffer;
+
+ public:
+  explicit FlatBuilder(std::size_t capacity = 256) {
+    m_buffer.reserve(capacity);
+    clear();
+  }
+
+  // Start a new buffer, keeping the capacity
+  void clear() { m_buffer.assign(sizeof(detail::FlatHeader), std::byte{0}); }
+
+  // Append a copy of value
+  template <typename T>
+  Offset<T> create(const T& value) {
+    detail::checkFlatType<T>();
+    const std::size_t position = append(sizeof(T), alignof(T));
+    std::memcpy(m_buffer.data() + position, &value, sizeof(T));
+    return Offset<T>{std::uint32_t(position)};
+  }
+
+  // Append count elements
+  template <typename T>
+  Offset<FlatVector<T>> createVector(const T* data, std::size_t count) {
+    detail::checkFlatType<T>();
+    constexpr std::size_t header = detail::flatVectorHeader<T>();
+    const std::size_t position =
+        append(header + count * sizeof(T), header > alignof(T) ? header
+                                                               : alignof(T));
+    const LittleEndian<std::uint32_t> size{std::uint32_t(count)};
+    std::memcpy(m_buffer.data() + position, &size, sizeof(size));
+    if (count > 0) {
+      std::memcpy(m_buffer.data() + position + header, data,
+                  count * sizeof(T));
+    }
+    return Offset<FlatVector<T>>{std::uint32_t(position)};
+  }
+
+  template <typename T>
+  Offset<FlatVector<T>> createVector(const std::vector<T>& values) {
+    return createVector(values.data(), values.size());
+  }
+
+  Offset<FlatString> createString(std::string_view text) {
+    return createVector(text.data(), text.size());
+  }
+
+  ///
+  /// @brief      Appends the root object and completes the header.
+  ///
+  /// @return     Pointer to and size of the finished buffer, valid until the
+  ///             builder is modified.
+  ///
+  template <typename T>
+  std::pair<const std::byte*, std::size_t> finish(const T& root) {
+    const Offset<T> offset = create(root);
+    const std::size_t size = append(0, detail::kFlatAlignment);
+    const detail::FlatHeader header{detail::kFlatMagic, std::uint32_t(size),
+                                    offset.position, 0};
+    std::memcpy(m_buffer.data(), &header, sizeof(header));
+    return {m_buffer.data(), size};
+  }
+
+ private:
+  // Reserve size bytes at alignment, zero filled, and return their position
+  std::size_t append(std::size_t size, std::size_t alignment) {
+    const std::size_t position =
+        (m_buffer.size() + alignment - 1) / alignment * alignment;
+    if (position + size > UINT32_MAX) {
+      throw std::length_error("FlatBuilder: buffer exceeds 4 GiB");
+    }
+    m_buffer.resize(position + size, std::byte{0});
+    return position;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// FlatView
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Reads a flat layout in place, e.g. from a received message or
+///             a mapped file, without deserializing or allocating. Every
+///             Offset is checked against the bounds and alignment of the
+///             buffer when it is resolved; a corrupt buffer throws
+///             std::out_of_range instead of reading out of bounds.
+///
+class FlatView final {
+ private:
+  const std::byte* m_data;
+  std::size_t m_size;
+
+ public:
+  ///
+  /// @brief      Checks the header. Throws std::invalid_argument if data is
+  ///             not a flat buffer, is truncated or is not 16 byte aligned.
+  ///
+  FlatView(const void* data, std::size_t size)
+      : m_data(static_cast<const std::byte*>(data)), m_size(size) {
+    if (reinterpret_cast<std::uintptr_t>(data) % detail::kFlatAlignment) {
+      throw std::invalid_argument("FlatView: buffer is not aligned");
+    }
+    if (size < sizeof(detail::FlatHeader)) {
+      throw std::invalid_argument("FlatView: buffer is too short");
+    }
+    const auto& header = *reinterpret_cast<const detail::FlatHeader*>(data);
+    if (header.magic.get() != detail::kFlatMagic) {
+      throw std::invalid_argument("FlatView: not a flat buffer");
+    }
+    if (header.size.get() > size) {
+      throw std::invalid_argument("FlatView: buffer is truncated");
+    }
+    m_size = header.size.get();
+  }
+
+  FlatView(std::pair<const std::byte*, std::size_t> buffer)
+      : FlatView(buffer.first, buffer.second) {}
+
+  std::size_t size() const { return m_size; }
+
+  // The root object passed to FlatBuilder::finish()
+  template <typename T>
+  const T& root() const {
+    const auto& header = *reinterpret_cast<const detail::FlatHeader*>(m_data);
+    const T* object = resolve(Offset<T>{header.root});
+    if (object == nullptr) throw std::out_of_range("FlatView: null root");
+    return *object;
+  }
+
+  // The object an offset refers to, nullptr if the offset is null
+  template <typename T>
+  const T* resolve(Offset<T> offset) const {
+    detail::checkFlatType<T>();
+    if (!offset) return nullptr;
+    return reinterpret_cast<const T*>(
+        check(offset.position.get(), sizeof(T), alignof(T)));
+  }
+
+  // The elements of a vector, empty if the offset is null
+  template <typename T>
+  FlatSpan<T> vector(Offset<FlatVector<T>> offset) const {
+    detail::checkFlatType<T>();
+    if (!offset) return {};
+    constexpr std::size_t header = detail::flatVectorHeader<T>();
+    const std::size_t position = offset.position.get();
+    const auto& count = *reinterpret_cast<const LittleEndian<std::uint32_t>*>(
+        check(position, header, header > alignof(T) ? header : alignof(T)));
+    const std::byte* elements =
+        check(position + header, std::size_t(count.get()) * sizeof(T), 1);
+    return {reinterpret_cast<const T*>(elements), count.get()};
+  }
+
+  std::string_view string(Offset<FlatString> offset) const {
+    const FlatSpan<char> characters = vector(offset);
+    return {characters.data(), characters.size()};
+  }
+
+ private:
+  // Pointer to size bytes at position, which must be inside the buffer and
+  // past the header
+  const std::byte* check(std::size_t position, std::size_t size,
+                         std::size_t alignment) const {
+    if (position < sizeof(detail::FlatHeader) || position > m_size ||
+        size > m_size - position || position % alignment != 0) {
+      throw std::out_of_range("FlatView: offset out of bounds");
+    }
+    return m_data + position;
+  }
+};
+
+}  // namespace ibex
@@ -3,11 +3,185 @@
 #include <ibex/Storage.h>
 
 #include <functional>
+#include <initializer_list>
+#include <type_traits>
 
 namespace ibex {
 
+namespace detail {
 
-template <typename, size_t>
+// Same layout as Function::Target: a vtable pointer followed by the functor
+struct ErasedTargetLayout {
+  virtual ~ErasedTargetLayout() = default;
+};
+
+template <typename Functor>
+struct TargetLayout final : ErasedTargetLayout {
+  Functor f;
+};
+
+// Rounds up to a multiple of 16 up to 64 bytes, above that to a multiple of a
+// quarter of the next lower power of two (80, 96, 112, 128, 160, ...). This
+// bounds both the wasted space and the number of distinct Function types.
+constexpr std::size_t roundToSizeClass(std::size_t size) {
+  if (size <= 64) return (size + 15) / 16 * 16;
+  std::size_t power = 64;
+  while (2 * power < size) power *= 2;
+  const std::size_t step = power / 4;
+  return (size + step - 1) / step * step;
+}
+
+// Passes an argument for a by-value parameter across the erased call boundary
+// by reference. The target constructs its parameter from it with take(), so
+// an lvalue is copied and an rvalue moved exactly once, straight into the
+// parameter of the target.
+template <typename Param>
+class ParamRef {
+ private:
+  Param* m_value;
+  bool m_copy;
+
+ public:
+  template <typename P = Param,
+            typename = std::enable_if_t<std::is_copy_constructible_v<P>>>
+  ParamRef(const Param& value)
+      : m_value(const_cast<Param*>(&value)), m_copy(true) {}
+  ParamRef(Param&& value) : m_value(&value), m_copy(false) {}
+
+  Param take() const {
+    if constexpr (std::is_copy_constructible_v<Param>) {
+      if (m_copy) return *static_cast<const Param*>(m_value);
+    }
+    return std::move(*m_value);
+  }
+};
+
+// What crosses the erased call boundary for a parameter of type Param
+template <typename Param>
+using ErasedParam =
+    std::conditional_t<std::is_reference_v<Param>, Param, ParamRef<Param>>;
+
+template <typename Param>
+decltype(auto) fromErased(ErasedParam<Param>& param) {
+  if constexpr (std::is_reference_v<Param>) {
+    return std::forward<Param>(param);
+  } else {
+    return param.take();
+  }
+}
+
+// Converts a call argument into what is passed across the erased call
+// boundary for a parameter of type Param. Arguments of the parameter type and
+// reference parameters are passed through as references; arguments of other
+// types are converted to a Param here and then moved into the target.
+template <typename Param, typename Arg>
+decltype(auto) toParam(Arg&& arg) {
+  if constexpr (std::is_reference_v<Param> ||
+                std::is_same_v<std::decay_t<Arg>, Param>) {
+    return std::forward<Arg>(arg);
+  } else {
+    return Param(std::forward<Arg>(arg));
+  }
+}
+
+template <typename T, typename Args, typename = void>
+struct IsBraceConstructible : std::false_type {};
+
+template <typename T, typename... Args>
+struct IsBraceConstructible<
+    T, void(Args...), std::void_t<decltype(T{std::declval<Args>()...})>>
+    : std::true_type {};
+
+// Parameter of the call operator chosen for braced initializer lists, which
+// the forwarding call operator cannot deduce. Its constructors mirror list
+// initialization of the parameter; a single argument must be implicitly
+// convertible, so plain arguments are not accepted that the forwarding
+// operator rejected. Non-const lvalue reference parameters take no lists.
+template <typename Param,
+          bool = std::is_lvalue_reference_v<Param> &&
+                 !std::is_const_v<std::remove_reference_t<Param>>>
+struct BracedParam {
+  using value_t = std::remove_cv_t<std::remove_reference_t<Param>>;
+  value_t value;
+
+  BracedParam() : value() {}
+
+  BracedParam(value_t&& v) : value(std::move(v)) {}
+
+  template <typename V = value_t,
+            typename = std::enable_if_t<std::is_copy_constructible_v<V>>>
+  BracedParam(const value_t& v) : value(v) {}
+
+  template <typename E,
+            typename = std::enable_if_t<
+                std::is_constructible_v<value_t, std::initializer_list<E>>>>
+  BracedParam(std::initializer_list<E> list) : value(list) {}
+
+  template <typename... Us,
+            typename = std::enable_if_t<
+                (sizeof...(Us) >= 2) &&
+                IsBraceConstructible<value_t, void(Us&&...)>::value>>
+  BracedParam(Us&&... args) : value{std::forward<Us>(args)...} {}
+};
+
+template <typename Param>
+struct BracedParam<Param, true> {
+  BracedParam() = delete;
+};
+
+template <typename Params, typename CallArgs, typename = void>
+struct ArgsConvertible : std::false_type {};
+
+template <typename... Params, typename... CallArgs>
+struct ArgsConvertible<
+    void(Params...), void(CallArgs...),
+    std::enable_if_t<sizeof...(Params) == sizeof...(CallArgs)>>
+    : std::conjunction<std::is_convertible<CallArgs, Params>...> {};
+
+// Moves the target of a DeferredFunction into the Graveyard of the calling
+// thread. Defined in Graveyard.h, so only deferred Functions depend on it.
+template <typename Erased, std::size_t Size>
+void buryTarget(ErasedStorage<Erased, Size>& target);
+
+// Instantiated only to fail: the compiler prints the template arguments, i.e.
+// the sizes of the capture and of the target, next to the requested Size.
+template <std::size_t CaptureSize, std::size_t TargetSize,
+          std::size_t RequestedSize, bool Fits>
+struct FunctionTargetFits {
+  static_assert(Fits,
+                "Target does not fit into Function. See the template "
+                "arguments for the capture size, the required and the "
+                "requested Size, or use ibex::make_function.");
+  static constexpr bool value = Fits;
+};
+
+}  // namespace detail
+
+///
+/// @brief      Number of bytes a Function needs to store a Functor.
+///
+template <typename Functor>
+inline constexpr std::size_t function_target_size_v =
+    sizeof(detail::TargetLayout<std::decay_t<Functor>>);
+
+///
+/// @brief      Whether a Functor can be stored in a Function of the given Size.
+///
+template <typename Functor, std::size_t Size>
+inline constexpr bool fits_in_v =
+    function_target_size_v<Functor> <= sizeof(std::aligned_storage_t<Size>) &&
+    alignof(detail::TargetLayout<std::decay_t<Functor>>) <=
+        alignof(std::aligned_storage_t<Size>);
+
+///
+/// @brief      Smallest Size, rounded up to a size class, of a Function that
+///             can store a Functor.
+///
+template <typename Functor>
+inline constexpr std::size_t function_size_v =
+    detail::roundToSizeClass(function_target_size_v<Functor>);
+
+template <typename, size_t, bool = false>
 class Function;
 
 ///
@@ -18,11 +192,13 @@ class Function;
 ///               std::unique_ptr in a target.
 ///
 /// @tparam     Size       Maximal target size in bytes
+/// @tparam     Deferred   Bury targets in the Graveyard instead of destroying
+///                        them, see DeferredFunction in Graveyard.h
 /// @tparam     R          Target return type
 /// @tparam     Args       Target argument types
 ///
-template <std::size_t Size, typename R, typename... Args>
-class Function<R(Args...), Size> final {
+template <std::size_t Size, bool Deferred, typename R, typename... Args>
+class Function<R(Args...), Size, Deferred> final {
  private:
   // ---------------------------------------------------------------------------
   // Child Classes: Target Wrappers
@@ -31,7 +207,7 @@ class Function<R(Args...), Size> final {
   // Type erased target functor
   struct ErasedTarget {
     virtual ~ErasedTarget() {}
-    virtual R operator()(Args...) = 0;
+    virtual R operator()(detail::ErasedParam<Args>...) = 0;
     virtual void moveInto(void*) = 0;
   };
 
@@ -45,9 +221,9 @@ class Function<R(Args...), Size> final {
     Target(const functor_t& func) : f(func) {}
     ~Target() override = default;
 
-    // Call contained target
-    R operator()(Args... args) override {
-      return f(std::forward<Args>(args)...);
+    // Call contained target. By-value parameters are constructed here.
+    R operator()(detail::ErasedParam<Args>... args) override {
+      return f(detail::fromErased<Args>(args)...);
     }
 
     // Move contained target to a different memory location
@@ -69,13 +245,16 @@ class Function<R(Args...), Size> final {
   // Create an empty function
   Function() = default;
 
-  ~Function() {
-    if (m_isValid) m_storage.destroy();
-  }
+  ~Function() { clear(); }
 
   // Construct a Function from a movable or copyable callable
   template <typename Functor>
   Function(Functor&& f) : m_isValid{true} {
+    static_assert(sizeof(Target<Functor>) == function_target_size_v<Functor>,
+                  "Target layout must match detail::TargetLayout.");
+    static_assert(detail::FunctionTargetFits<
+                  sizeof(std::decay_t<Functor>), sizeof(Target<Functor>), Size,
+                  fits_in_v<Functor, Size>>::value);
     m_storage.template create<Target<Functor>>(std::forward<Functor>(f));
   }
 
@@ -91,9 +270,24 @@ class Function<R(Args...), Size> final {
   }
 
   // Invoke the contained target. Throws if no valid target has been stored.
-  R operator()(Args... args) const {
+  // Arguments are forwarded by reference up to the target, so a by-value
+  // parameter is copied from an lvalue or moved from an rvalue exactly once,
+  // directly into the parameter of the target.
+  template <typename... CallArgs,
+            typename = std::enable_if_t<detail::ArgsConvertible<
+                void(Args...), void(CallArgs&&...)>::value>>
+  R operator()(CallArgs&&... args) const {
     if (!m_isValid) throw std::bad_function_call{};
-    return m_storage.get()(std::forward<Args>(args)...);
+    return m_storage.get()(
+        detail::toParam<Args>(std::forward<CallArgs>(args))...);
+  }
+
+  // Invoke the contained target with braced initializer lists, e.g. f({1, 2}).
+  // Only chosen when the forwarding operator above cannot deduce them.
+  template <std::size_t N = sizeof...(Args), typename = std::enable_if_t<N != 0>>
+  R operator()(detail::BracedParam<Args>... args) const {
+    return (*this)(static_cast<std::remove_reference_t<Args>&&>(
+        args.value)...);
   }
 
   // Check whether a valid function is stored.
@@ -109,17 +303,34 @@ class Function<R(Args...), Size> final {
     if (other.m_isValid) {
       other.m_storage.get().moveInto(m_storage.raw());
       m_isValid = true;
-      other.clear();
+      // The moved-from target is cheap to destroy, never bury it
+      other.m_storage.destroy();
+      other.m_isValid = false;
     }
   }
 
-  // Cleanly destroy contained target
+  // Cleanly destroy contained target, or bury it if Deferred
   void clear() {
     if (m_isValid) {
+      if constexpr (Deferred) detail::buryTarget(m_storage);
       m_storage.destroy();
       m_isValid = false;
     }
   }
 };
 
+///
+/// @brief      Creates a Function with the smallest Size, rounded up to a size
+///             class, that fits the given callable.
+///
+/// @param      f          Callable target
+///
+/// @tparam     Signature  Call signature, e.g. int(int)
+///
+template <typename Signature, typename Functor>
+Function<Signature, function_size_v<Functor>> make_function(Functor&& f) {
+  return Function<Signature, function_size_v<Functor>>(
+      std::forward<Functor>(f));
+}
+
 }  // namespace ibex
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ibex {
+
+template <typename>
+class FunctionRef;
+
+///
+/// @brief      A non-owning reference to a callable, for callback parameters.
+///             Unlike ibex::Function it neither stores nor moves the target:
+///             it is two pointers wide, trivially copyable and calls through a
+///             single indirect call. The referenced callable must outlive the
+///             FunctionRef, so it is best used for parameters only.
+///
+/// @tparam     R     Target return type
+/// @tparam     Args  Target argument types
+///
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)> final {
+ private:
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  void* m_object;
+  R (*m_invoke)(void*, Args...);
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  // Reference any callable, including functions and lambdas
+  template <typename Functor,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Functor>, FunctionRef> &&
+                std::is_invocable_r_v<R, Functor&, Args...>>>
+  FunctionRef(Functor&& f) {
+    using functor_t = std::remove_reference_t<Functor>;
+    if constexpr (std::is_function_v<std::remove_pointer_t<functor_t>>) {
+      // Functions are not objects, keep the function pointer itself
+      using pointer_t = std::decay_t<Functor>;
+      m_object = reinterpret_cast<void*>(static_cast<pointer_t>(f));
+      m_invoke = [](void* object, Args... args) -> R {
+        return reinterpret_cast<pointer_t>(object)(
+            std::forward<Args>(args)...);
+      };
+    } else {
+      m_object = const_cast<void*>(
+          static_cast<const void*>(std::addressof(f)));
+      m_invoke = [](void* object, Args... args) -> R {
+        return (*static_cast<functor_t*>(object))(
+            std::forward<Args>(args)...);
+      };
+    }
+  }
+
+  // Invoke the referenced callable
+  R operator()(Args... args) const {
+    return m_invoke(m_object, std::forward<Args>(args)...);
+  }
+};
+
+}  // namespace ibex
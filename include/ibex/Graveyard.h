@@ -0,0 +1,251 @@
+#pragma once
+
+#include <ibex/CommandBuffer.h>
+#include <ibex/Function.h>
+#include <ibex/Storage.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+// ---------------------------------------------------------------------------
+// Graveyard
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Moves the destruction of objects off latency-critical threads.
+///             Every thread has its own Graveyard. Burying an object moves it
+///             into a CommandBuffer that only the owning thread touches, so
+///             burying takes no lock. A drain() on the owning thread, e.g.
+///             from an idle hook, destroys everything buried so far.
+///             A drain() from any other thread, e.g. by a GraveyardDrainer,
+///             destroys what the owner has handed over and asks it to hand
+///             over the rest, which it does under a lock on its next bury().
+///             Whatever is left is destroyed when the owning thread exits.
+///
+class Graveyard final {
+ private:
+  // Keeps an object alive inside a CommandBuffer record
+  template <typename T>
+  struct Corpse {
+    T object;
+    void operator()() {}
+  };
+
+  // Keeps a type-erased Function target alive, see DeferredFunction
+  template <typename Erased, std::size_t Size>
+  struct ErasedCorpse {
+    ErasedStorage<Erased, Size> target;
+
+    explicit ErasedCorpse(ErasedStorage<Erased, Size>& source) {
+      source.get().moveInto(target.raw());
+    }
+    ErasedCorpse(const ErasedCorpse&) = delete;
+    ~ErasedCorpse() { target.destroy(); }
+
+    void operator()() {}
+  };
+
+  template <typename Erased, std::size_t Size>
+  friend void detail::buryTarget(ErasedStorage<Erased, Size>& target);
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  const std::thread::id m_owner{std::this_thread::get_id()};
+  CommandBuffer m_buried;  // Only touched by the owning thread
+  std::atomic<bool> m_handOverRequested{false};
+  std::mutex m_mutex;  // Guards m_handedOver, only taken to hand over
+  CommandBuffer m_handedOver;
+  std::mutex m_drainMutex;  // Guards m_draining
+  CommandBuffer m_draining;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  Graveyard(const Graveyard&) = delete;
+  Graveyard& operator=(const Graveyard&) = delete;
+
+  ~Graveyard() {
+    {
+      // Waits for a running drainAll(), which may still use this graveyard
+      std::lock_guard<std::mutex> drainLock(drainAllMutex());
+      std::lock_guard<std::mutex> lock(registryMutex());
+      auto& graveyards = registry();
+      graveyards.erase(std::find(graveyards.begin(), graveyards.end(), this));
+    }
+    // Runs the remaining destructors while they can still bury
+    drain();
+  }
+
+  // Graveyard of the calling thread
+  static Graveyard& local() {
+    thread_local Graveyard graveyard;
+    return graveyard;
+  }
+
+  ///
+  /// @brief      Moves object into the graveyard of the calling thread. Its
+  ///             destructor runs on a later drain(), or when the thread exits.
+  ///             Must be called on the owning thread, i.e. through local().
+  ///
+  template <typename T>
+  void bury(T&& object) {
+    m_buried.push(Corpse<std::decay_t<T>>{std::forward<T>(object)});
+    handOverIfRequested();
+  }
+
+  ///
+  /// @brief      Destroys buried objects. On the owning thread this is
+  ///             everything buried so far; on other threads it is what the
+  ///             owner has handed over since the previous drain.
+  ///
+  /// @return     Number of destroyed objects.
+  ///
+  std::size_t drain() {
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::swap(m_handedOver, m_draining);
+    }
+    std::size_t count = m_draining.size();
+    m_draining.reset();
+    if (std::this_thread::get_id() == m_owner) {
+      // Destructors may bury more objects, which must not be appended to the
+      // buffer being reset, so m_buried is swapped out until none are left
+      while (!m_buried.empty()) {
+        std::swap(m_buried, m_draining);
+        count += m_draining.size();
+        m_draining.reset();
+      }
+    } else {
+      m_handOverRequested.store(true, std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  ///
+  /// @brief      Drains the graveyards of all threads.
+  ///
+  /// @return     Number of destroyed objects.
+  ///
+  static std::size_t drainAll() {
+    std::lock_guard<std::mutex> drainLock(drainAllMutex());
+    std::vector<Graveyard*> graveyards;
+    {
+      std::lock_guard<std::mutex> lock(registryMutex());
+      graveyards = registry();
+    }
+    // Without the registry lock, as destructors that bury may register the
+    // graveyard of this thread
+    std::size_t count = 0;
+    for (Graveyard* graveyard : graveyards) count += graveyard->drain();
+    return count;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  Graveyard() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().push_back(this);
+  }
+
+  static std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // Held by drainAll(), so graveyards outlive its drain() calls
+  static std::mutex& drainAllMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<Graveyard*>& registry() {
+    static std::vector<Graveyard*> graveyards;
+    return graveyards;
+  }
+
+  // A relaxed load on every bury, the lock only after a drain asked for it
+  void handOverIfRequested() {
+    if (!m_handOverRequested.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_handedOver.empty()) std::swap(m_buried, m_handedOver);
+    m_handOverRequested.store(false, std::memory_order_relaxed);
+  }
+};
+
+///
+/// @brief      A Function that does not destroy its target inline. On
+///             destruction, and when overwritten by move assignment, the
+///             target is moved into the Graveyard of the current thread and
+///             destroyed when that is drained.
+///
+template <typename Signature, std::size_t Size>
+using DeferredFunction = Function<Signature, Size, true>;
+
+namespace detail {
+
+template <typename Erased, std::size_t Size>
+void buryTarget(ErasedStorage<Erased, Size>& target) {
+  Graveyard& graveyard = Graveyard::local();
+  graveyard.m_buried.emplace<Graveyard::ErasedCorpse<Erased, Size>>(target);
+  graveyard.handOverIfRequested();
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// GraveyardDrainer
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Background thread that periodically drains all graveyards,
+///             and once more when it is stopped.
+///
+class GraveyardDrainer final {
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_stop{false};
+  std::thread m_thread;
+
+ public:
+  explicit GraveyardDrainer(std::chrono::milliseconds interval)
+      : m_thread([this, interval] {
+          Graveyard::local();  // Registered before draining, not during it
+          std::unique_lock<std::mutex> lock(m_mutex);
+          for (;;) {
+            m_wakeup.wait_for(lock, interval, [this] { return m_stop; });
+            const bool stop = m_stop;
+            lock.unlock();
+            Graveyard::drainAll();
+            if (stop) break;
+            lock.lock();
+          }
+        }) {}
+
+  GraveyardDrainer(const GraveyardDrainer&) = delete;
+  GraveyardDrainer& operator=(const GraveyardDrainer&) = delete;
+
+  ~GraveyardDrainer() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wakeup.notify_one();
+    m_thread.join();
+  }
+};
+
+}  // namespace ibex
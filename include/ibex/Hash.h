@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ibex {
+
+namespace detail {
+
+inline constexpr std::uint64_t kHashSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+    0x4d5a2da51de1aa47ull};
+
+// Full 64 x 64 bit product, folded to 64 bits by xoring its halves
+inline std::uint64_t foldedMultiply(std::uint64_t a, std::uint64_t b) {
+  const __uint128_t product = __uint128_t(a) * b;
+  return std::uint64_t(product) ^ std::uint64_t(product >> 64);
+}
+
+// Unaligned little endian loads, so hashes are the same on every platform
+inline std::uint64_t readHash64(const unsigned char* p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  if constexpr (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) {
+    value = __builtin_bswap64(value);
+  }
+  return value;
+}
+
+inline std::uint64_t readHash32(const unsigned char* p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  if constexpr (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) {
+    value = __builtin_bswap32(value);
+  }
+  return value;
+}
+
+// Detects a hashValue(const T&) overload found by argument dependent lookup
+template <typename T, typename = void>
+struct HasHashValue : std::false_type {};
+
+template <typename T>
+struct HasHashValue<
+    T, std::void_t<decltype(hashValue(std::declval<const T&>()))>>
+    : std::true_type {};
+
+}  // namespace detail
+
+///
+/// @brief      Mixes an integer such that every input bit affects every output
+///             bit with probability close to 1/2 (the finaliser of
+///             MurmurHash3). The mapping is a bijection, so distinct integers
+///             never collide, and the low bits are safe to use as the index
+///             of a power-of-two table.
+///
+constexpr std::uint64_t hashInteger(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+///
+/// @brief      Hashes a byte range with the wyhash algorithm: inputs of up to
+///             16 bytes take two overlapping reads and two multiplications,
+///             longer ones are consumed 48 bytes at a time in three
+///             independent lanes. Not suitable against adversarial input
+///             unless the seed is secret.
+///
+/// @param      data  First byte.
+/// @param      size  Number of bytes.
+/// @param      seed  Selects an independent hash function.
+///
+/// @return     A hash with full avalanche.
+///
+inline std::uint64_t hashBytes(const void* data, std::size_t size,
+                               std::uint64_t seed = 0) {
+  using detail::foldedMultiply;
+  using detail::kHashSecret;
+  using detail::readHash32;
+  using detail::readHash64;
+
+  const auto* p = static_cast<const unsigned char*>(data);
+  seed ^= foldedMultiply(seed ^ kHashSecret[0], kHashSecret[1]);
+  std::uint64_t a = 0;
+  std::uint64_t b = 0;
+  if (size <= 16) {
+    if (size >= 4) {
+      // Four reads of 4 bytes cover 4 to 16 bytes, overlapping if shorter
+      const std::size_t middle = (size >> 3) << 2;
+      a = (readHash32(p) << 32) | readHash32(p + middle);
+      b = (readHash32(p + size - 4) << 32) | readHash32(p + size - 4 - middle);
+    } else if (size > 0) {
+      a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[size >> 1]) << 8) |
+          p[size - 1];
+    }
+  } else {
+    std::size_t remaining = size;
+    if (remaining >= 48) {
+      std::uint64_t lane1 = seed;
+      std::uint64_t lane2 = seed;
+      do {
+        seed = foldedMultiply(readHash64(p) ^ kHashSecret[1],
+                              readHash64(p + 8) ^ seed);
+        lane1 = foldedMultiply(readHash64(p + 16) ^ kHashSecret[2],
+                               readHash64(p + 24) ^ lane1);
+        lane2 = foldedMultiply(readHash64(p + 32) ^ kHashSecret[3],
+                               readHash64(p + 40) ^ lane2);
+        p += 48;
+        remaining -= 48;
+      } while (remaining >= 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while (remaining > 16) {
+      seed = foldedMultiply(readHash64(p) ^ kHashSecret[1],
+                            readHash64(p + 8) ^ seed);
+      p += 16;
+      remaining -= 16;
+    }
+    // The last 16 bytes, overlapping the previous round if needed
+    a = readHash64(p + remaining - 16);
+    b = readHash64(p + remaining - 8);
+  }
+  const __uint128_t product =
+      __uint128_t(a ^ kHashSecret[1]) * (b ^ seed);
+  return foldedMultiply(std::uint64_t(product) ^ kHashSecret[0] ^ size,
+                        std::uint64_t(product >> 64) ^ kHashSecret[1]);
+}
+
+inline std::uint64_t hashString(std::string_view str, std::uint64_t seed = 0) {
+  return hashBytes(str.data(), str.size(), seed);
+}
+
+///
+/// @brief      Folds hash into seed. The result depends on the order of the
+///             calls, so combining (a, b) and (b, a) gives different hashes.
+///
+inline std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t hash) {
+  return detail::foldedMultiply(seed ^ detail::kHashSecret[0],
+                                hash ^ detail::kHashSecret[1]);
+}
+
+template <typename... Ts>
+std::uint64_t hashValues(const Ts&... values);
+
+///
+/// @brief      Hash function object with full avalanche, a drop-in
+///             replacement for std::hash. Supports integers, enums, pointers,
+///             floating point numbers, strings, pairs and tuples. Other types
+///             are hashed by a hashValue(const T&) function found by argument
+///             dependent lookup, typically written with hashValues(), or else
+///             by std::hash<T> followed by hashInteger().
+///
+/// @tparam     T     Key type.
+///
+template <typename T, typename = void>
+struct Hash {
+  // Tells hash tables that the low bits need no further mixing
+  using is_avalanching = void;
+
+  std::size_t operator()(const T& value) const {
+    if constexpr (detail::HasHashValue<T>::value) {
+      return std::size_t(hashValue(value));
+    } else {
+      return std::size_t(hashInteger(std::hash<T>{}(value)));
+    }
+  }
+};
+
+template <typename T>
+struct Hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>> {
+  using is_avalanching = void;
+
+  std::size_t operator()(T value) const {
+    if constexpr (std::is_enum_v<T>) {
+      return std::size_t(
+          hashInteger(std::uint64_t(std::underlying_type_t<T>(value))));
+    } else {
+      return std::size_t(hashInteger(std::uint64_t(value)));
+    }
+  }
+};
+
+template <typename T>
+struct Hash<T*> {
+  using is_avalanching = void;
+
+  std::size_t operator()(T* pointer) const {
+    return std::size_t(hashInteger(reinterpret_cast<std::uintptr_t>(pointer)));
+  }
+};
+
+template <typename T>
+struct Hash<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+  using is_avalanching = void;
+
+  std::size_t operator()(T value) const {
+    // Equal values must hash equally: -0.0 == 0.0, and long double padding
+    // bytes are not part of the value
+    const double wide = value == T(0) ? 0.0 : double(value);
+    std::uint64_t bits;
+    std::memcpy(&bits, &wide, sizeof(bits));
+    return std::size_t(hashInteger(bits));
+  }
+};
+
+template <>
+struct Hash<std::string_view> {
+  using is_avalanching = void;
+  // Allows heterogeneous lookup in std::unordered_map in C++20
+  using is_transparent = void;
+
+  std::size_t operator()(std::string_view str) const {
+    return std::size_t(hashString(str));
+  }
+};
+
+template <>
+struct Hash<std::string> : Hash<std::string_view> {};
+
+template <typename First, typename Second>
+struct Hash<std::pair<First, Second>> {
+  using is_avalanching = void;
+
+  std::size_t operator()(const std::pair<First, Second>& pair) const {
+    return std::size_t(hashValues(pair.first, pair.second));
+  }
+};
+
+template <typename... Ts>
+struct Hash<std::tuple<Ts...>> {
+  using is_avalanching = void;
+
+  std::size_t operator()(const std::tuple<Ts...>& tuple) const {
+    return std::apply(
+        [](const Ts&... values) { return std::size_t(hashValues(values...)); },
+        tuple);
+  }
+};
+
+///
+/// @brief      Hashes several values in order, e.g. the members of a struct:
+///
+///                 std::uint64_t hashValue(const Point& p) {
+///                   return ibex::hashValues(p.x, p.y);
+///                 }
+///
+template <typename... Ts>
+std::uint64_t hashValues(const Ts&... values) {
+  std::uint64_t seed = 0;
+  ((seed = hashCombine(seed, Hash<Ts>{}(values))), ...);
+  return seed;
+}
+
+}  // namespace ibex
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace ibex {
+
+///
+/// @brief      A bump allocator for scratch memory whose first N bytes live
+///             inside the object, typically on the stack of a hot function.
+///             Only when they are exhausted are further blocks, growing
+///             geometrically, requested from a parent resource.
+///             Deallocation only reclaims memory if it was the most recent
+///             allocation, e.g. a temporary freed before anything else is
+///             allocated; everything else is released by reset() or when the
+///             arena goes out of scope. A growing std::pmr::vector allocates
+///             its new buffer before freeing the old one, so every growth step
+///             takes fresh space: reserve() the final size where possible.
+///             Not thread-safe.
+///
+///             Use highWaterMark() to tune N: if it stays below N, the parent
+///             is never touched.
+///
+/// @tparam     N          Size of the inline buffer in bytes
+/// @tparam     Alignment  Alignment of the inline buffer
+///
+template <std::size_t N, std::size_t Alignment = alignof(std::max_align_t)>
+class InlineArena final : public std::pmr::memory_resource {
+ private:
+  // Precedes every block obtained from the parent
+  struct alignas(std::max_align_t) SpillBlock {
+    SpillBlock* previous;
+    std::size_t size;
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  alignas(Alignment) std::array<std::byte, N> m_buffer;
+  std::byte* m_cursor{m_buffer.data()};
+  std::byte* m_end{m_buffer.data() + N};
+  std::byte* m_last{nullptr};  // Start of the most recent allocation
+  SpillBlock* m_spilled{nullptr};
+  std::pmr::memory_resource* m_parent;
+  std::size_t m_used{0};
+  std::size_t m_highWaterMark{0};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @param      parent  Resource for memory beyond the inline buffer.
+  ///
+  explicit InlineArena(
+      std::pmr::memory_resource* parent = std::pmr::get_default_resource())
+      : m_parent(parent) {}
+
+  InlineArena(const InlineArena&) = delete;
+  InlineArena& operator=(const InlineArena&) = delete;
+
+  ~InlineArena() { releaseSpilled(); }
+
+  ///
+  /// @brief      Returns size bytes aligned to alignment, from the inline
+  ///             buffer if they fit.
+  ///
+  void* allocate(std::size_t size,
+                 std::size_t alignment = alignof(std::max_align_t)) {
+    std::byte* start = alignUp(m_cursor, alignment);
+    if (start > m_end || std::size_t(m_end - start) < size) {
+      spill(size, alignment);
+      start = alignUp(m_cursor, alignment);
+    }
+    m_used += std::size_t(start + size - m_cursor);
+    if (m_used > m_highWaterMark) m_highWaterMark = m_used;
+    m_last = start;
+    m_cursor = start + size;
+    return start;
+  }
+
+  ///
+  /// @brief      Gives back memory if it was the most recent allocation,
+  ///             otherwise does nothing.
+  ///
+  void deallocate(void* pointer, std::size_t size,
+                  std::size_t = alignof(std::max_align_t)) {
+    if (pointer == m_last && m_last + size == m_cursor) {
+      m_used -= size;
+      m_cursor = m_last;
+      m_last = nullptr;
+    }
+  }
+
+  // Release all allocations, returning spilled blocks to the parent
+  void reset() {
+    releaseSpilled();
+    m_cursor = m_buffer.data();
+    m_end = m_buffer.data() + N;
+    m_last = nullptr;
+    m_used = 0;
+  }
+
+  // A std::pmr allocator using this arena
+  template <typename T = std::byte>
+  std::pmr::polymorphic_allocator<T> allocator() {
+    return std::pmr::polymorphic_allocator<T>(this);
+  }
+
+  static constexpr std::size_t capacity() { return N; }
+
+  // Bytes currently allocated, including alignment padding
+  std::size_t used() const { return m_used; }
+
+  // Largest used() since construction, across reset()
+  std::size_t highWaterMark() const { return m_highWaterMark; }
+
+  // Whether memory has been requested from the parent since the last reset
+  bool spilled() const { return m_spilled != nullptr; }
+
+  // ---------------------------------------------------------------------------
+  // std::pmr::memory_resource
+  // ---------------------------------------------------------------------------
+ private:
+  void* do_allocate(std::size_t size, std::size_t alignment) override {
+    return allocate(size, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t size,
+                     std::size_t alignment) override {
+    deallocate(pointer, size, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+  static std::byte* alignUp(std::byte* pointer, std::size_t alignment) {
+    const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+    return pointer + ((alignment - address % alignment) % alignment);
+  }
+
+  // Continue in a new block from the parent, at least twice the last one
+  void spill(std::size_t size, std::size_t alignment) {
+    const std::size_t last = m_spilled != nullptr ? m_spilled->size : N;
+    std::size_t blockSize = sizeof(SpillBlock) + size + alignment;
+    if (blockSize < 2 * last) blockSize = 2 * last;
+
+    void* memory = m_parent->allocate(blockSize, alignof(SpillBlock));
+    m_spilled = new (memory) SpillBlock{m_spilled, blockSize};
+    m_cursor = reinterpret_cast<std::byte*>(m_spilled) + sizeof(SpillBlock);
+    m_end = reinterpret_cast<std::byte*>(m_spilled) + blockSize;
+  }
+
+  void releaseSpilled() {
+    while (m_spilled != nullptr) {
+      SpillBlock* previous = m_spilled->previous;
+      m_parent->deallocate(m_spilled, m_spilled->size, alignof(SpillBlock));
+      m_spilled = previous;
+    }
+  }
+};
+
+}  // namespace ibex
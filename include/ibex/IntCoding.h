@@ -0,0 +1,472 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define IBEX_INT_CODING_SIMD 1
+#endif
+
+namespace ibex {
+
+// ---------------------------------------------------------------------------
+// Varints
+// ---------------------------------------------------------------------------
+
+// Maps signed integers to unsigned ones so that small magnitudes stay small
+inline std::uint64_t zigzagEncode(std::int64_t value) {
+  return (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+}
+
+inline std::int64_t zigzagDecode(std::uint64_t value) {
+  return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+}
+
+///
+/// @brief      Writes value as an LEB128 varint: seven bits per byte, least
+///             significant first, the high bit set on all but the last byte.
+///
+/// @param      out   Destination with room for at least 10 bytes.
+///
+/// @return     Number of bytes written.
+///
+inline std::size_t encodeVarint(std::uint64_t value, std::uint8_t* out) {
+  std::size_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = std::uint8_t(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = std::uint8_t(value);
+  return size;
+}
+
+///
+/// @brief      Reads one varint and advances cursor past it. Throws
+///             std::out_of_range if the input ends inside the varint and
+///             std::invalid_argument if it is longer than 10 bytes.
+///
+inline std::uint64_t decodeVarint(const std::uint8_t*& cursor,
+                                  const std::uint8_t* end) {
+  std::uint64_t value = 0;
+  for (unsigned shift = 0; shift < 70; shift += 7) {
+    if (cursor == end) throw std::out_of_range("decodeVarint: truncated");
+    const std::uint8_t byte = *cursor++;
+    value |= std::uint64_t(byte & 0x7f) << shift;
+    if (byte < 0x80) return value;
+  }
+  throw std::invalid_argument("decodeVarint: longer than 10 bytes");
+}
+
+///
+/// @brief      Writes count values as consecutive varints.
+///
+/// @param      out   Destination with room for 10 bytes per value.
+///
+/// @return     Number of bytes written.
+///
+template <typename T>
+std::size_t encodeVarints(const T* values, std::size_t count,
+                          std::uint8_t* out) {
+  static_assert(std::is_unsigned_v<T>, "Varints encode unsigned values (T).");
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    size += encodeVarint(values[i], out + size);
+  }
+  return size;
+}
+
+#ifdef IBEX_INT_CODING_SIMD
+
+namespace detail {
+
+///
+/// @brief      How to decode the varints that end in a window of 8 bytes,
+///             indexed by the mask of their last bytes: a shuffle that moves
+///             each varint into a 16-bit lane, if all of them have at most 2
+///             bytes, or the first up to 4 into 32-bit lanes, if those have
+///             at most 4 bytes. Longer varints are decoded one at a time.
+///
+struct VarintShuffle {
+  std::uint8_t shuffle[16];
+  std::uint8_t count;     // Varints decoded
+  std::uint8_t consumed;  // Bytes consumed
+  std::uint8_t laneBits;  // 16, 32 or 0 for a long first varint
+};
+
+constexpr std::array<VarintShuffle, 256> makeVarintShuffles() {
+  std::array<VarintShuffle, 256> shuffles{};
+  for (unsigned mask = 0; mask < 256; ++mask) {
+    unsigned starts[8] = {};
+    unsigned lengths[8] = {};
+    unsigned found = 0;
+    unsigned start = 0;
+    unsigned longest = 0;
+    for (unsigned byte = 0; byte < 8; ++byte) {
+      if ((mask >> byte & 1) == 0) continue;
+      starts[found] = start;
+      lengths[found] = byte + 1 - start;
+      if (lengths[found] > longest) longest = lengths[found];
+      start = byte + 1;
+      ++found;
+    }
+
+    VarintShuffle& entry = shuffles[mask];
+    for (std::uint8_t& index : entry.shuffle) index = 0x80;  // Zero
+    if (found == 0 || lengths[0] > 4) continue;
+
+    const unsigned laneBytes = longest <= 2 ? 2 : 4;
+    unsigned count = 0;
+    while (count < found && count < 16 / laneBytes &&
+           lengths[count] <= laneBytes) {
+      for (unsigned byte = 0; byte < lengths[count]; ++byte) {
+        entry.shuffle[count * laneBytes + byte] =
+            std::uint8_t(starts[count] + byte);
+      }
+      ++count;
+    }
+    entry.count = std::uint8_t(count);
+    entry.consumed =
+        std::uint8_t(starts[count - 1] + lengths[count - 1]);
+    entry.laneBits = std::uint8_t(8 * laneBytes);
+  }
+  return shuffles;
+}
+
+inline constexpr std::array<VarintShuffle, 256> kVarintShuffles =
+    makeVarintShuffles();
+
+// Writes 4 decoded values to out
+template <typename T>
+void storeVarints(__m128i values, T* out) {
+  if constexpr (sizeof(T) == 4) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), values);
+  } else {
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), values);
+    for (std::size_t k = 0; k < 4; ++k) out[k] = T(lanes[k]);
+  }
+}
+
+// Decodes the varints ending in the low 8 bytes, writing up to 8 values to
+// out. Nothing is decoded if the first varint is longer than 4 bytes.
+template <typename T>
+__attribute__((target("ssse3"))) const VarintShuffle& decodeVarintWindow(
+    __m128i bytes, unsigned terminators, T* out) {
+  const VarintShuffle& entry = kVarintShuffles[terminators];
+  const __m128i x = _mm_shuffle_epi8(
+      bytes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(entry.shuffle)));
+  if (entry.laneBits == 16) {
+    const __m128i merged = _mm_or_si128(
+        _mm_and_si128(x, _mm_set1_epi16(0x7f)),
+        _mm_srli_epi16(_mm_and_si128(x, _mm_set1_epi16(0x7f00)), 1));
+    storeVarints(_mm_unpacklo_epi16(merged, _mm_setzero_si128()), out);
+    storeVarints(_mm_unpackhi_epi16(merged, _mm_setzero_si128()), out + 4);
+  } else if (entry.laneBits == 32) {
+    __m128i merged = _mm_and_si128(x, _mm_set1_epi32(0x7f));
+    merged = _mm_or_si128(merged, _mm_and_si128(_mm_srli_epi32(x, 1),
+                                                _mm_set1_epi32(0x3f80)));
+    merged = _mm_or_si128(merged, _mm_and_si128(_mm_srli_epi32(x, 2),
+                                                _mm_set1_epi32(0x1fc000)));
+    merged = _mm_or_si128(merged, _mm_and_si128(_mm_srli_epi32(x, 3),
+                                                _mm_set1_epi32(0xfe00000)));
+    storeVarints(merged, out);
+  }
+  return entry;
+}
+
+///
+/// @brief      Decodes varints while at least 16 values are wanted and 16
+///             bytes are left.
+///
+/// @return     Number of decoded varints.
+///
+template <typename T>
+__attribute__((target("ssse3"))) std::size_t decodeVarintsSsse3(
+    const std::uint8_t*& in, const std::uint8_t* end, T* out,
+    std::size_t count) {
+  std::size_t i = 0;
+  while (count - i >= 16 && end - in >= 16) {
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const auto terminators = ~unsigned(_mm_movemask_epi8(bytes)) & 0xffff;
+    if (terminators == 0xffff) {  // 16 single bytes
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+      const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+      storeVarints(_mm_unpacklo_epi16(low, zero), out + i);
+      storeVarints(_mm_unpackhi_epi16(low, zero), out + i + 4);
+      storeVarints(_mm_unpacklo_epi16(high, zero), out + i + 8);
+      storeVarints(_mm_unpackhi_epi16(high, zero), out + i + 12);
+      in += 16;
+      i += 16;
+      continue;
+    }
+
+    const VarintShuffle& low =
+        decodeVarintWindow(bytes, terminators & 0xff, out + i);
+    if (low.consumed == 0) {
+      out[i++] = T(decodeVarint(in, end));  // Longer than 4 bytes
+      continue;
+    }
+    i += low.count;
+    in += low.consumed;
+    // If the low half ended on a varint, the high half can be decoded from
+    // the same load
+    if (low.consumed == 8) {
+      const VarintShuffle& high = decodeVarintWindow(
+          _mm_srli_si128(bytes, 8), terminators >> 8, out + i);
+      i += high.count;
+      in += high.consumed;
+    }
+  }
+  return i;
+}
+
+inline bool hasSsse3() {
+  static const bool has = __builtin_cpu_supports("ssse3");
+  return has;
+}
+
+}  // namespace detail
+
+#endif
+
+///
+/// @brief      Reads count consecutive varints. If the CPU supports SSSE3,
+///             the continuation bits of 16 bytes are read at once: 16 single
+///             byte values are widened in one step, otherwise a shuffle looked
+///             up by the continuation bits decodes up to 8 varints of up to 2
+///             bytes, or 4 of up to 4 bytes, without a branch per byte.
+///             Throws like decodeVarint(); values too large for T are
+///             truncated.
+///
+/// @return     Cursor past the last decoded varint.
+///
+template <typename T>
+const std::uint8_t* decodeVarints(const std::uint8_t* in,
+                                  const std::uint8_t* end, T* out,
+                                  std::size_t count) {
+  static_assert(std::is_unsigned_v<T>, "Varints decode unsigned values (T).");
+  std::size_t i = 0;
+#ifdef IBEX_INT_CODING_SIMD
+  if (detail::hasSsse3()) i = detail::decodeVarintsSsse3(in, end, out, count);
+#endif
+  for (; i < count; ++i) out[i] = T(decodeVarint(in, end));
+  return in;
+}
+
+// ---------------------------------------------------------------------------
+// Bit Packing
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Bit packing works on blocks of 128 values. They are stored in
+///             four interleaved lanes of 32 values each, so that the shifts
+///             of all four lanes are identical and the packing loops compile
+///             to 128-bit SIMD instructions.
+///
+inline constexpr std::size_t kPackedBlockSize = 128;
+
+// Number of bits needed to store value
+inline unsigned bitWidth(std::uint32_t value) {
+  return value == 0 ? 0 : 32 - unsigned(__builtin_clz(value));
+}
+
+// 32-bit words used by a block packed with the given bit width
+constexpr std::size_t packedBlockWords(unsigned bits) { return 4 * bits; }
+
+namespace detail {
+
+template <unsigned Bits>
+void packBlock(const std::uint32_t* in, std::uint32_t* out) {
+  // Width 0 writes no words, and out may be null then
+  if constexpr (Bits > 0) {
+    std::memset(out, 0, packedBlockWords(Bits) * sizeof(std::uint32_t));
+    for (unsigned row = 0; row < 32; ++row) {
+      const unsigned word = row * Bits / 32;
+      const unsigned shift = row * Bits % 32;
+      for (unsigned lane = 0; lane < 4; ++lane) {
+        const std::uint32_t value = in[row * 4 + lane];
+        out[word * 4 + lane] |= value << shift;
+        if (shift + Bits > 32) {
+          out[(word + 1) * 4 + lane] |= value >> ((32 - shift) & 31);
+        }
+      }
+    }
+  }
+}
+
+template <unsigned Bits>
+void unpackBlock(const std::uint32_t* in, std::uint32_t* out) {
+  if constexpr (Bits == 0) {
+    std::memset(out, 0, kPackedBlockSize * sizeof(std::uint32_t));
+  } else {
+    constexpr std::uint32_t mask =
+        Bits == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << Bits) - 1;
+    for (unsigned row = 0; row < 32; ++row) {
+      const unsigned word = row * Bits / 32;
+      const unsigned shift = row * Bits % 32;
+      for (unsigned lane = 0; lane < 4; ++lane) {
+        std::uint32_t value = in[word * 4 + lane] >> shift;
+        if (shift + Bits > 32) {
+          value |= in[(word + 1) * 4 + lane] << ((32 - shift) & 31);
+        }
+        out[row * 4 + lane] = value & mask;
+      }
+    }
+  }
+}
+
+using PackFunction = void (*)(const std::uint32_t*, std::uint32_t*);
+
+template <std::size_t... Bits>
+constexpr std::array<PackFunction, sizeof...(Bits)> packTable(
+    std::index_sequence<Bits...>) {
+  return {&packBlock<unsigned(Bits)>...};
+}
+
+template <std::size_t... Bits>
+constexpr std::array<PackFunction, sizeof...(Bits)> unpackTable(
+    std::index_sequence<Bits...>) {
+  return {&unpackBlock<unsigned(Bits)>...};
+}
+
+}  // namespace detail
+
+///
+/// @brief      Packs 128 values of at most bits bits each into
+///             packedBlockWords(bits) words.
+///
+inline void packBlock(const std::uint32_t* in, unsigned bits,
+                      std::uint32_t* out) {
+  static constexpr auto table =
+      detail::packTable(std::make_index_sequence<33>{});
+  table[bits](in, out);
+}
+
+// Reverses packBlock(), writing 128 values
+inline void unpackBlock(const std::uint32_t* in, unsigned bits,
+                        std::uint32_t* out) {
+  static constexpr auto table =
+      detail::unpackTable(std::make_index_sequence<33>{});
+  table[bits](in, out);
+}
+
+// Extracts value index of a packed block without unpacking it
+inline std::uint32_t unpackValue(const std::uint32_t* in, unsigned bits,
+                                 std::size_t index) {
+  if (bits == 0) return 0;
+  const std::size_t row = index / 4;
+  const std::size_t lane = index % 4;
+  const std::size_t word = row * bits / 32;
+  const std::size_t shift = row * bits % 32;
+  std::uint64_t value = in[word * 4 + lane] >> shift;
+  if (shift + bits > 32) {
+    value |= std::uint64_t(in[(word + 1) * 4 + lane]) << (32 - shift);
+  }
+  return std::uint32_t(value & ((std::uint64_t(1) << bits) - 1));
+}
+
+// ---------------------------------------------------------------------------
+// Delta + Frame of Reference
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Encodes a sequence as deltas between consecutive values, minus
+///             the smallest delta of their block, bit-packed in blocks of 128.
+///             Sorted ID lists with small gaps shrink to a few bits per value.
+///             Unsorted input is valid too, deltas wrap around.
+///
+///             Layout: the value count, then per block the smallest delta,
+///             the bit width and the packed words. The last block is padded.
+///
+inline std::vector<std::uint32_t> encodeDeltaPacked(
+    const std::uint32_t* values, std::size_t count) {
+  std::vector<std::uint32_t> words;
+  words.reserve(1 + count / 4);
+  words.push_back(std::uint32_t(count));
+
+  std::array<std::uint32_t, kPackedBlockSize> deltas;
+  std::uint32_t previous = 0;
+  for (std::size_t start = 0; start < count; start += kPackedBlockSize) {
+    const std::size_t size =
+        count - start < kPackedBlockSize ? count - start : kPackedBlockSize;
+    std::uint32_t reference = ~std::uint32_t(0);
+    for (std::size_t i = 0; i < size; ++i) {
+      deltas[i] = values[start + i] - previous;
+      previous = values[start + i];
+      if (deltas[i] < reference) reference = deltas[i];
+    }
+    std::uint32_t spread = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      deltas[i] -= reference;
+      spread |= deltas[i];
+    }
+    for (std::size_t i = size; i < kPackedBlockSize; ++i) deltas[i] = 0;
+
+    const unsigned bits = bitWidth(spread);
+    words.push_back(reference);
+    words.push_back(bits);
+    const std::size_t offset = words.size();
+    words.resize(offset + packedBlockWords(bits));
+    packBlock(deltas.data(), bits, words.data() + offset);
+  }
+  return words;
+}
+
+inline std::vector<std::uint32_t> encodeDeltaPacked(
+    const std::vector<std::uint32_t>& values) {
+  return encodeDeltaPacked(values.data(), values.size());
+}
+
+///
+/// @brief      Decodes the output of encodeDeltaPacked(). Throws
+///             std::out_of_range if words is truncated or corrupt.
+///
+inline std::vector<std::uint32_t> decodeDeltaPacked(const std::uint32_t* words,
+                                                    std::size_t size) {
+  if (size == 0) throw std::out_of_range("decodeDeltaPacked: empty input");
+  const std::size_t count = words[0];
+  // Every block takes at least its reference and bit width, so a count that
+  // needs more blocks than fit is rejected before allocating for it
+  const std::size_t blocks = (count + kPackedBlockSize - 1) / kPackedBlockSize;
+  if (blocks > (size - 1) / (2 + packedBlockWords(0))) {
+    throw std::out_of_range("decodeDeltaPacked: truncated input");
+  }
+  std::vector<std::uint32_t> values(
+      (count + kPackedBlockSize - 1) / kPackedBlockSize * kPackedBlockSize);
+
+  std::size_t position = 1;
+  std::uint32_t previous = 0;
+  for (std::size_t start = 0; start < count; start += kPackedBlockSize) {
+    if (size - position < 2 || words[position + 1] > 32 ||
+        size - position - 2 < packedBlockWords(words[position + 1])) {
+      throw std::out_of_range("decodeDeltaPacked: truncated input");
+    }
+    const std::uint32_t reference = words[position];
+    const unsigned bits = words[position + 1];
+    std::uint32_t* block = values.data() + start;
+    unpackBlock(words + position + 2, bits, block);
+    for (std::size_t i = 0; i < kPackedBlockSize; ++i) {
+      previous += block[i] + reference;
+      block[i] = previous;
+    }
+    position += 2 + packedBlockWords(bits);
+  }
+  values.resize(count);
+  return values;
+}
+
+inline std::vector<std::uint32_t> decodeDeltaPacked(
+    const std::vector<std::uint32_t>& words) {
+  return decodeDeltaPacked(words.data(), words.size());
+}
+
+}  // namespace ibex
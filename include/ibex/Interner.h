@@ -0,0 +1,241 @@
+#pragma once
+
+#include <ibex/Hash.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      Maps strings to compact 32-bit ids and back.
+///             The bytes of every interned string are copied once into arena
+///             blocks and never move, so the returned string_views stay valid
+///             for the lifetime of the Interner.
+///             Looking up strings that are already interned is lock-free:
+///             each thread first checks a small direct-mapped cache of recent
+///             lookups, then probes an open-addressing index with acquire
+///             loads. Only inserting a new string takes a mutex.
+///
+class Interner final {
+ public:
+  using Id = std::uint32_t;
+
+ private:
+  // Id -> string_view chunks, chunk k holds kFirstChunk << k entries
+  static constexpr std::size_t kFirstChunk = 256;
+  static constexpr std::size_t kMaxChunks = 24;
+  static constexpr std::size_t kBlockSize = 64 * 1024;
+  static constexpr std::size_t kCacheSize = 256;
+
+  // ---------------------------------------------------------------------------
+  // Child Classes
+  // ---------------------------------------------------------------------------
+
+  // Open-addressing index. A slot holds the upper hash bits in its high half
+  // and id + 1 in its low half, 0 marks an empty slot.
+  struct Table {
+    std::size_t mask;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+
+    explicit Table(std::size_t capacity)
+        : mask(capacity - 1),
+          slots(new std::atomic<std::uint64_t>[capacity]) {
+      for (std::size_t i = 0; i < capacity; ++i) slots[i].store(0);
+    }
+  };
+
+  struct CacheEntry {
+    std::uint64_t owner{0};
+    std::size_t hash{0};
+    Id id{0};
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::array<std::atomic<std::string_view*>, kMaxChunks> m_chunks{};
+  std::atomic<Table*> m_table{nullptr};
+  std::atomic<std::size_t> m_size{0};
+  const std::uint64_t m_instance;
+
+  // Only accessed under m_mutex
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<Table>> m_tables;  // Current one is last
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  char* m_blockCursor{nullptr};
+  std::size_t m_blockRemaining{0};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  Interner() : m_instance(nextInstance()) {
+    m_tables.push_back(std::make_unique<Table>(1024));
+    m_table.store(m_tables.back().get(), std::memory_order_release);
+  }
+
+  Interner(const Interner&) = delete;
+  Interner& operator=(const Interner&) = delete;
+
+  ~Interner() {
+    for (auto& chunk : m_chunks) delete[] chunk.load();
+  }
+
+  ///
+  /// @brief      Returns the id of str, interning a copy of it if necessary.
+  ///
+  /// @return     Id of str. Ids are assigned consecutively from 0.
+  ///
+  Id intern(std::string_view str) {
+    const std::size_t hash = Hash<std::string_view>{}(str);
+    if (auto id = lookup(str, hash)) return *id;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto id = probe(*m_tables.back(), str, hash)) return *id;
+    return insert(str, hash);
+  }
+
+  ///
+  /// @brief      Looks up str without interning it. Lock-free.
+  ///
+  /// @return     Id of str, or nothing if str has not been interned.
+  ///
+  std::optional<Id> find(std::string_view str) const {
+    return lookup(str, Hash<std::string_view>{}(str));
+  }
+
+  ///
+  /// @brief      Access the string of an id. Lock-free.
+  ///
+  /// @note       Calling this with an id not returned by this Interner is
+  ///             undefined behaviour.
+  ///
+  std::string_view view(Id id) const {
+    const auto [chunk, offset] = locate(id);
+    return m_chunks[chunk].load(std::memory_order_acquire)[offset];
+  }
+
+  // Number of interned strings
+  std::size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  static std::uint64_t nextInstance() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+  }
+
+  static std::array<CacheEntry, kCacheSize>& threadCache() {
+    thread_local std::array<CacheEntry, kCacheSize> cache{};
+    return cache;
+  }
+
+  // Chunk and offset within the chunk of the string_view of an id
+  static std::pair<std::size_t, std::size_t> locate(Id id) {
+    std::size_t chunk = 0;
+    std::size_t offset = id;
+    while (offset >= (kFirstChunk << chunk)) {
+      offset -= kFirstChunk << chunk;
+      ++chunk;
+    }
+    return {chunk, offset};
+  }
+
+  static std::uint32_t tagOf(std::size_t hash) {
+    return static_cast<std::uint32_t>(std::uint64_t(hash) >> 32);
+  }
+
+  // Lock-free lookup: thread cache first, then the current index
+  std::optional<Id> lookup(std::string_view str, std::size_t hash) const {
+    CacheEntry& entry = threadCache()[hash & (kCacheSize - 1)];
+    if (entry.owner == m_instance && entry.hash == hash &&
+        view(entry.id) == str) {
+      return entry.id;
+    }
+    auto id = probe(*m_table.load(std::memory_order_acquire), str, hash);
+    if (id) entry = CacheEntry{m_instance, hash, *id};
+    return id;
+  }
+
+  std::optional<Id> probe(const Table& table, std::string_view str,
+                          std::size_t hash) const {
+    const std::uint32_t tag = tagOf(hash);
+    for (std::size_t i = hash & table.mask;; i = (i + 1) & table.mask) {
+      const std::uint64_t slot =
+          table.slots[i].load(std::memory_order_acquire);
+      if (slot == 0) return std::nullopt;
+      const Id id = static_cast<Id>(slot) - 1;
+      if (static_cast<std::uint32_t>(slot >> 32) == tag && view(id) == str) {
+        return id;
+      }
+    }
+  }
+
+  static void place(Table& table, std::size_t hash, Id id) {
+    std::size_t i = hash & table.mask;
+    while (table.slots[i].load(std::memory_order_relaxed) != 0) {
+      i = (i + 1) & table.mask;
+    }
+    table.slots[i].store((std::uint64_t(tagOf(hash)) << 32) | (id + 1),
+                         std::memory_order_release);
+  }
+
+  // Copy str into the arena and publish it. Requires m_mutex.
+  Id insert(std::string_view str, std::size_t hash) {
+    const Id id = static_cast<Id>(m_size.load(std::memory_order_relaxed));
+    const std::string_view stored = copyToArena(str);
+
+    const auto [chunk, offset] = locate(id);
+    std::string_view* views = m_chunks[chunk].load(std::memory_order_relaxed);
+    if (views == nullptr) {
+      views = new std::string_view[kFirstChunk << chunk];
+      m_chunks[chunk].store(views, std::memory_order_release);
+    }
+    views[offset] = stored;
+
+    // Keep the load factor below one half. Readers still probing an older
+    // table simply miss newer strings and fall back to the locked path.
+    Table* table = m_tables.back().get();
+    if (2 * (id + 1) > table->mask + 1) {
+      auto grown = std::make_unique<Table>(2 * (table->mask + 1));
+      for (Id i = 0; i < id; ++i) {
+        place(*grown, Hash<std::string_view>{}(view(i)), i);
+      }
+      table = grown.get();
+      m_tables.push_back(std::move(grown));
+      m_table.store(table, std::memory_order_release);
+    }
+
+    place(*table, hash, id);
+    m_size.store(id + 1, std::memory_order_release);
+    return id;
+  }
+
+  std::string_view copyToArena(std::string_view str) {
+    if (str.size() > m_blockRemaining) {
+      const std::size_t size =
+          str.size() > kBlockSize ? str.size() : kBlockSize;
+      m_blocks.emplace_back(new char[size]);
+      m_blockCursor = m_blocks.back().get();
+      m_blockRemaining = size;
+    }
+    if (!str.empty()) std::memcpy(m_blockCursor, str.data(), str.size());
+    const std::string_view stored(m_blockCursor, str.size());
+    m_blockCursor += str.size();
+    m_blockRemaining -= str.size();
+    return stored;
+  }
+};
+
+}  // namespace ibex
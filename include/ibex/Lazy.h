@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ibex/Function.h>
+#include <ibex/Storage.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace ibex {
+
+///
+/// @brief      A value that is constructed by an initializer on first access.
+///             After initialization, access is a single acquire load of the
+///             state word. Under contention exactly one thread runs the
+///             initializer while the others block. The initializer is
+///             destroyed right after it has run, releasing its captures.
+///             If the initializer throws, the exception is propagated and the
+///             next access tries again.
+///
+/// @tparam     T     Type of the value
+/// @tparam     Size  Maximal initializer size in bytes
+///
+template <typename T, std::size_t Size>
+class Lazy final {
+ private:
+  enum State : std::uint8_t { Uninitialized, Ready };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::atomic<std::uint8_t> m_state{Uninitialized};
+  mutable Storage<T> m_storage;
+  Function<T(), Size> m_init;
+  std::mutex m_mutex;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  // Create a lazy value from a callable returning T
+  template <typename Functor,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Functor>, Lazy>>>
+  explicit Lazy(Functor&& init) : m_init(std::forward<Functor>(init)) {}
+
+  Lazy(const Lazy&) = delete;
+  Lazy& operator=(const Lazy&) = delete;
+
+  ~Lazy() {
+    if (m_state.load(std::memory_order_acquire) == Ready) m_storage.destroy();
+  }
+
+  ///
+  /// @brief      Access the value, running the initializer if necessary.
+  ///
+  /// @return     Reference to the value, valid for the lifetime of the Lazy.
+  ///
+  T& get() {
+    if (m_state.load(std::memory_order_acquire) != Ready) initialize();
+    return m_storage.get();
+  }
+
+  T& operator*() { return get(); }
+  T* operator->() { return &get(); }
+
+  // Check whether the initializer has run
+  bool initialized() const {
+    return m_state.load(std::memory_order_acquire) == Ready;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  void initialize() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_state.load(std::memory_order_relaxed) == Ready) return;
+    m_storage.create(m_init());
+    m_init = Function<T(), Size>{};
+    m_state.store(Ready, std::memory_order_release);
+  }
+};
+
+}  // namespace ibex
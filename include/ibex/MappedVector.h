@@ -0,0 +1,339 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace ibex {
+
+///
+/// @brief      How a MappedVector opens its file.
+///
+enum class MapMode {
+  ReadOnly,   // Open an existing file, modifications throw
+  ReadWrite,  // Open an existing file, or create it if there is none
+  Truncate,   // Create a new file, discarding any existing contents
+};
+
+///
+/// @brief      Describes the layout of a MappedVector file. It is checked on
+///             every open, so a file written for a different type or schema
+///             is rejected instead of being misread.
+///
+struct MappedVectorHeader {
+  static constexpr char kMagic[8] = {'I', 'B', 'E', 'X', 'M', 'V', 'E', 'C'};
+  static constexpr std::uint32_t kVersion = 1;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t typeSize;
+  std::uint32_t typeAlignment;
+  std::uint32_t dataOffset;  // Bytes from the file start to element 0
+  std::uint64_t schema;
+  std::uint64_t size;  // Number of elements
+};
+
+///
+/// @brief      A vector of trivially copyable elements stored in a file that
+///             is mapped into memory. Opening an existing file is instant and
+///             only the pages that are touched are read, which turns the
+///             rebuild of large lookup tables on restart into a warm start.
+///             Growth extends the file with ftruncate() and remaps it, which
+///             may move the elements in memory: like std::vector, growing
+///             invalidates pointers.
+///             Changes reach the file through the page cache; call flush() to
+///             make them durable at a known point. Elements are stored in the
+///             byte order of the host. Not thread-safe.
+///
+/// @tparam     T     Element type, must be trivially copyable
+///
+template <typename T>
+class MappedVector final {
+ private:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "MappedVector elements must be trivially copyable (T).");
+
+  static constexpr std::size_t kDataOffset =
+      (sizeof(MappedVectorHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  int m_file{-1};
+  void* m_mapping{nullptr};
+  std::size_t m_mappedBytes{0};
+  std::size_t m_capacity{0};
+  bool m_readOnly{false};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Opens or creates the file at path. Throws std::system_error
+  ///             if the file cannot be opened or mapped, and
+  ///             std::runtime_error if its header does not match T or schema.
+  ///
+  /// @param      path    File to map.
+  /// @param      mode    How to open the file, see MapMode.
+  /// @param      schema  Any stable 64-bit tag of the element layout, e.g. a
+  ///                     version number or a hash of a schema description.
+  ///                     Bump it when T changes in a way that keeps its size
+  ///                     and alignment.
+  ///
+  MappedVector(const std::string& path, MapMode mode,
+               std::uint64_t schema = 0)
+      : m_readOnly(mode == MapMode::ReadOnly) {
+    int flags = m_readOnly ? O_RDONLY : O_RDWR | O_CREAT;
+    if (mode == MapMode::Truncate) flags |= O_TRUNC;
+    m_file = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (m_file < 0) fail("open " + path);
+
+    try {
+      struct stat status;
+      if (::fstat(m_file, &status) != 0) fail("fstat " + path);
+      if (status.st_size == 0 && !m_readOnly) {
+        initialize(schema);
+      } else if (std::size_t(status.st_size) < kDataOffset) {
+        throw std::runtime_error("MappedVector: " + path + " is too short");
+      } else {
+        map(std::size_t(status.st_size));
+        validate(path, schema);
+      }
+    } catch (...) {
+      close();
+      throw;
+    }
+  }
+
+  MappedVector(MappedVector&& other)
+      : m_file(std::exchange(other.m_file, -1)),
+        m_mapping(std::exchange(other.m_mapping, nullptr)),
+        m_mappedBytes(std::exchange(other.m_mappedBytes, 0)),
+        m_capacity(std::exchange(other.m_capacity, 0)),
+        m_readOnly(other.m_readOnly) {}
+
+  MappedVector& operator=(MappedVector&& other) {
+    if (this != &other) {
+      close();
+      m_file = std::exchange(other.m_file, -1);
+      m_mapping = std::exchange(other.m_mapping, nullptr);
+      m_mappedBytes = std::exchange(other.m_mappedBytes, 0);
+      m_capacity = std::exchange(other.m_capacity, 0);
+      m_readOnly = other.m_readOnly;
+    }
+    return *this;
+  }
+
+  ~MappedVector() { close(); }
+
+  // A moved-from vector has no mapping and is empty
+  std::size_t size() const {
+    return m_mapping == nullptr ? 0 : std::size_t(header().size);
+  }
+  bool empty() const { return size() == 0; }
+  std::size_t capacity() const { return m_capacity; }
+  bool readOnly() const { return m_readOnly; }
+  std::uint64_t schema() const { return header().schema; }
+
+  T* data() { return reinterpret_cast<T*>(bytes() + kDataOffset); }
+  const T* data() const {
+    return reinterpret_cast<const T*>(bytes() + kDataOffset);
+  }
+
+  T& operator[](std::size_t index) { return data()[index]; }
+  const T& operator[](std::size_t index) const { return data()[index]; }
+
+  T& at(std::size_t index) {
+    checkIndex(index);
+    return data()[index];
+  }
+
+  const T& at(std::size_t index) const {
+    checkIndex(index);
+    return data()[index];
+  }
+
+  T& front() { return data()[0]; }
+  const T& front() const { return data()[0]; }
+  T& back() { return data()[size() - 1]; }
+  const T& back() const { return data()[size() - 1]; }
+
+  T* begin() { return data(); }
+  T* end() { return data() + size(); }
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + size(); }
+
+  // Append an element, growing the file geometrically when it is full
+  void pushBack(const T& value) {
+    checkWritable();
+    const std::size_t count = size();
+    if (count == m_capacity) {
+      // value may be an element, which grow() can move or unmap
+      const T copy = value;
+      grow(count == 0 ? 1 : 2 * count);
+      append(count, copy);
+    } else {
+      append(count, value);
+    }
+  }
+
+  // Constructs the element before growing, as args may refer to elements
+  template <typename... Args>
+  T& emplaceBack(Args&&... args) {
+    const T value(std::forward<Args>(args)...);
+    pushBack(value);
+    return data()[size() - 1];
+  }
+
+  void popBack() {
+    checkWritable();
+    header().size = size() - 1;
+  }
+
+  // Resize to count elements; new elements are value initialized
+  void resize(std::size_t count) {
+    checkWritable();
+    const std::size_t old = size();
+    if (count > m_capacity) grow(count);
+    for (std::size_t i = old; i < count; ++i) new (data() + i) T();
+    header().size = count;
+  }
+
+  void clear() { resize(0); }
+
+  // Extend the file to hold at least count elements
+  void reserve(std::size_t count) {
+    checkWritable();
+    if (count > m_capacity) grow(count);
+  }
+
+  ///
+  /// @brief      Writes modified pages back to the file.
+  ///
+  /// @param      wait  Block until the data is on disk; otherwise only
+  ///                   schedule the write-back.
+  ///
+  void flush(bool wait = true) {
+    if (m_readOnly) return;
+    if (::msync(m_mapping, m_mappedBytes, wait ? MS_SYNC : MS_ASYNC) != 0) {
+      fail("msync");
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(),
+                            "MappedVector: " + what);
+  }
+
+  std::byte* bytes() const { return static_cast<std::byte*>(m_mapping); }
+
+  MappedVectorHeader& header() {
+    return *reinterpret_cast<MappedVectorHeader*>(m_mapping);
+  }
+
+  const MappedVectorHeader& header() const {
+    return *reinterpret_cast<const MappedVectorHeader*>(m_mapping);
+  }
+
+  void append(std::size_t count, const T& value) {
+    std::memcpy(static_cast<void*>(data() + count), &value, sizeof(T));
+    header().size = count + 1;
+  }
+
+  void checkIndex(std::size_t index) const {
+    if (index >= size()) {
+      throw std::out_of_range("MappedVector: index out of range");
+    }
+  }
+
+  void checkWritable() const {
+    if (m_readOnly) throw std::logic_error("MappedVector: opened read-only");
+  }
+
+  void initialize(std::uint64_t schema) {
+    map(resizeFile(kDataOffset));
+    MappedVectorHeader& head = header();
+    std::memcpy(head.magic, MappedVectorHeader::kMagic, sizeof(head.magic));
+    head.version = MappedVectorHeader::kVersion;
+    head.typeSize = sizeof(T);
+    head.typeAlignment = alignof(T);
+    head.dataOffset = kDataOffset;
+    head.schema = schema;
+    head.size = 0;
+  }
+
+  void validate(const std::string& path, std::uint64_t schema) {
+    const MappedVectorHeader& head = header();
+    const char* mismatch = nullptr;
+    if (std::memcmp(head.magic, MappedVectorHeader::kMagic,
+                    sizeof(head.magic)) != 0) {
+      mismatch = "is not a MappedVector file";
+    } else if (head.version != MappedVectorHeader::kVersion) {
+      mismatch = "has an unsupported format version";
+    } else if (head.typeSize != sizeof(T) ||
+               head.typeAlignment != alignof(T) ||
+               head.dataOffset != kDataOffset) {
+      mismatch = "was written for a different element type";
+    } else if (head.schema != schema) {
+      mismatch = "was written for a different schema";
+    } else if (head.size > m_capacity) {
+      mismatch = "is truncated";
+    }
+    if (mismatch != nullptr) {
+      throw std::runtime_error("MappedVector: " + path + " " + mismatch);
+    }
+  }
+
+  // Set the file length, returning it
+  std::size_t resizeFile(std::size_t fileBytes) {
+    if (::ftruncate(m_file, off_t(fileBytes)) != 0) fail("ftruncate");
+    return fileBytes;
+  }
+
+  void map(std::size_t fileBytes) {
+    const int protection = m_readOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* mapping =
+        ::mmap(nullptr, fileBytes, protection, MAP_SHARED, m_file, 0);
+    if (mapping == MAP_FAILED) fail("mmap");
+    m_mapping = mapping;
+    m_mappedBytes = fileBytes;
+    m_capacity = (fileBytes - kDataOffset) / sizeof(T);
+  }
+
+  void grow(std::size_t count) {
+    const std::size_t fileBytes = resizeFile(kDataOffset + count * sizeof(T));
+    void* mapping =
+        ::mremap(m_mapping, m_mappedBytes, fileBytes, MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED) fail("mremap");
+    m_mapping = mapping;
+    m_mappedBytes = fileBytes;
+    m_capacity = count;
+  }
+
+  void close() {
+    if (m_mapping != nullptr) ::munmap(m_mapping, m_mappedBytes);
+    if (m_file >= 0) ::close(m_file);
+    m_mapping = nullptr;
+    m_mappedBytes = 0;
+    m_capacity = 0;
+    m_file = -1;
+  }
+};
+
+}  // namespace ibex
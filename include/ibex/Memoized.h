@@ -0,0 +1,297 @@
+#pragma once
+
+#include <ibex/Function.h>
+#include <ibex/Hash.h>
+#include <ibex/Storage.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace ibex {
+
+template <typename, std::size_t, std::size_t = 64, bool = false>
+class Memoized;
+
+///
+/// @brief      Wraps an ibex::Function with a bounded cache of its results.
+///             The cache is a fixed-size open-addressing table: a key is
+///             looked for in up to four consecutive slots, and when they are
+///             all taken the result in the key's home slot is replaced.
+///             Results are stored in ibex::Storage slots, so neither R nor Key
+///             need to be default constructible.
+///
+/// @tparam     Size       Maximal target size in bytes
+/// @tparam     Capacity   Number of cached results, must be a power of two
+/// @tparam     PerThread  If true, every calling thread gets its own cache and
+///                        the Memoized can be called concurrently, provided
+///                        the target can. Otherwise it is not thread-safe,
+///                        just like ibex::Function.
+/// @tparam     R          Target return type
+/// @tparam     Key        Target argument type, must be hashable and equality
+///                        comparable
+///
+template <std::size_t Size, std::size_t Capacity, bool PerThread, typename R,
+          typename Key>
+class Memoized<R(Key), Size, Capacity, PerThread> final {
+ private:
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two (Capacity).");
+
+  using key_t = std::remove_cv_t<std::remove_reference_t<Key>>;
+
+  static constexpr std::size_t kMask = Capacity - 1;
+  static constexpr std::size_t kProbes = Capacity < 4 ? Capacity : 4;
+
+  // ---------------------------------------------------------------------------
+  // Child Classes
+  // ---------------------------------------------------------------------------
+
+  struct Slot {
+    bool used{false};
+    Storage<key_t> key;
+    Storage<R> value;
+  };
+
+  struct Cache {
+    std::array<Slot, Capacity> slots;
+    // Written by one thread only, atomic so stats() can read them
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+
+    ~Cache() { clear(); }
+
+    void clear() {
+      for (Slot& slot : slots) {
+        if (slot.used) {
+          slot.key.destroy();
+          slot.value.destroy();
+          slot.used = false;
+        }
+      }
+    }
+
+    static void count(std::atomic<std::uint64_t>& counter) {
+      counter.store(counter.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    }
+  };
+
+  struct ThreadCaches {
+    std::mutex mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<Cache>> caches;
+    // Counters of the caches of threads that have exited
+    std::uint64_t retiredHits{0};
+    std::uint64_t retiredMisses{0};
+  };
+
+  // Cache of the instance the calling thread used last. Trivially
+  // destructible, so it stays readable while other thread_local objects,
+  // which may still call a Memoized, are destroyed.
+  struct LastCache {
+    std::uint64_t instance;
+    Cache* cache;
+    bool exited;  // The thread has released its caches
+  };
+
+  // The caches the calling thread has used, by instance. They are released
+  // when the thread exits, or with their Memoized, whichever comes first.
+  struct ThreadState {
+    struct Entry {
+      std::weak_ptr<ThreadCaches> owner;
+      Cache* cache;
+    };
+
+    std::unordered_map<std::uint64_t, Entry, Hash<std::uint64_t>> entries;
+    std::size_t pruneAt{16};
+
+    ~ThreadState() {
+      for (auto& [instance, entry] : entries) {
+        const std::shared_ptr<ThreadCaches> owner = entry.owner.lock();
+        if (!owner) continue;
+        std::lock_guard<std::mutex> lock(owner->mutex);
+        owner->retiredHits += entry.cache->hits.load(std::memory_order_relaxed);
+        owner->retiredMisses +=
+            entry.cache->misses.load(std::memory_order_relaxed);
+        owner->caches.erase(std::this_thread::get_id());
+      }
+      lastCache() = LastCache{0, nullptr, true};
+    }
+
+    // Forget the caches of destroyed Memoized, once entries doubled
+    void prune() {
+      if (entries.size() < pruneAt) return;
+      for (auto it = entries.begin(); it != entries.end();) {
+        it = it->second.owner.expired() ? entries.erase(it) : std::next(it);
+      }
+      pruneAt = 2 * entries.size() > 16 ? 2 * entries.size() : 16;
+    }
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  Function<R(Key), Size> m_function;
+  std::unique_ptr<Cache> m_cache;  // Shared cache if not PerThread
+
+  // Caches of all threads, only used if PerThread. Held by pointer, so the
+  // Memoized stays movable and thread-local lookups survive a move.
+  std::uint64_t m_instance;
+  std::shared_ptr<ThreadCaches> m_threads;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  struct Stats {
+    std::uint64_t hits;
+    std::uint64_t misses;
+  };
+
+  // Wrap a callable target
+  template <typename Functor,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Functor>, Memoized>>>
+  Memoized(Functor&& f)
+      : m_function(std::forward<Functor>(f)),
+        m_cache(PerThread ? nullptr : new Cache),
+        m_instance(nextInstance()),
+        m_threads(PerThread ? std::make_shared<ThreadCaches>() : nullptr) {}
+
+  // Wrap an existing Function
+  Memoized(Function<R(Key), Size>&& function)
+      : m_function(std::move(function)),
+        m_cache(PerThread ? nullptr : new Cache),
+        m_instance(nextInstance()),
+        m_threads(PerThread ? std::make_shared<ThreadCaches>() : nullptr) {}
+
+  Memoized(const Memoized&) = delete;
+  Memoized& operator=(const Memoized&) = delete;
+
+  // Moves the target and the cached results; the source must not be called
+  // afterwards
+  Memoized(Memoized&&) = default;
+  Memoized& operator=(Memoized&&) = default;
+
+  ///
+  /// @brief      Returns the cached result for key, invoking the target and
+  ///             caching its result on a miss.
+  ///
+  R operator()(const key_t& key) {
+    Cache* local = localCache();
+    if (local == nullptr) return m_function(key);
+    Cache& cache = *local;
+    const std::size_t hash = Hash<key_t>{}(key);
+
+    std::size_t index = hash & kMask;
+    for (std::size_t p = 0; p < kProbes; ++p, index = (index + 1) & kMask) {
+      Slot& slot = cache.slots[index];
+      if (!slot.used) break;
+      if (slot.key.get() == key) {
+        Cache::count(cache.hits);
+        return slot.value.get();
+      }
+    }
+
+    Cache::count(cache.misses);
+    R result = m_function(key);
+    store(cache, hash, key, result);
+    return result;
+  }
+
+  // Drop all cached results of the calling thread, or all if not PerThread
+  void clear() {
+    if (Cache* cache = localCache()) cache->clear();
+  }
+
+  // Hits and misses summed over all caches, including released ones
+  Stats stats() {
+    if constexpr (PerThread) {
+      std::lock_guard<std::mutex> lock(m_threads->mutex);
+      Stats stats{m_threads->retiredHits, m_threads->retiredMisses};
+      for (const auto& [thread, cache] : m_threads->caches) {
+        stats.hits += cache->hits.load(std::memory_order_relaxed);
+        stats.misses += cache->misses.load(std::memory_order_relaxed);
+      }
+      return stats;
+    } else {
+      return {m_cache->hits.load(std::memory_order_relaxed),
+              m_cache->misses.load(std::memory_order_relaxed)};
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  static std::uint64_t nextInstance() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+  }
+
+  static LastCache& lastCache() {
+    thread_local LastCache last{0, nullptr, false};
+    return last;
+  }
+
+  // The shared cache, or the cache of the calling thread. nullptr if the
+  // thread has released its caches, results are not cached then.
+  Cache* localCache() {
+    if constexpr (PerThread) {
+      LastCache& last = lastCache();
+      if (last.instance == m_instance) return last.cache;
+      if (last.exited) return nullptr;
+
+      thread_local ThreadState state;
+      auto found = state.entries.find(m_instance);
+      if (found == state.entries.end()) {
+        state.prune();
+        found = state.entries
+                    .emplace(m_instance, typename ThreadState::Entry{
+                                             m_threads, createCache()})
+                    .first;
+      }
+      last = LastCache{m_instance, found->second.cache, false};
+      return last.cache;
+    } else {
+      return m_cache.get();
+    }
+  }
+
+  // Registers a cache for the calling thread
+  Cache* createCache() {
+    std::lock_guard<std::mutex> lock(m_threads->mutex);
+    auto& cache = m_threads->caches[std::this_thread::get_id()];
+    if (!cache) cache.reset(new Cache);
+    return cache.get();
+  }
+
+  // Cache result, replacing the entry in the home slot if all probes are used
+  static void store(Cache& cache, std::size_t hash, const key_t& key,
+                    const R& result) {
+    std::size_t target = hash & kMask;
+    std::size_t index = hash & kMask;
+    for (std::size_t p = 0; p < kProbes; ++p, index = (index + 1) & kMask) {
+      if (!cache.slots[index].used) {
+        target = index;
+        break;
+      }
+    }
+    Slot& slot = cache.slots[target];
+    if (slot.used) {
+      slot.key.destroy();
+      slot.value.destroy();
+    }
+    slot.key.create(key);
+    slot.value.create(result);
+    slot.used = true;
+  }
+};
+
+}  // namespace ibex
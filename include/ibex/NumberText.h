@@ -0,0 +1,267 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define IBEX_NUMBER_TEXT_SIMD 1
+#endif
+
+namespace ibex {
+
+// Buffer sizes that fit any formatted 64-bit integer or double
+inline constexpr std::size_t kMaxIntegerChars = 20;
+inline constexpr std::size_t kMaxFloatChars = 24;
+
+namespace detail {
+
+inline constexpr char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536"
+    "37383940414243444546474849505152535455565758596061626364656667686970717273"
+    "7475767778798081828384858687888990919293949596979899";
+
+inline unsigned countDigits(std::uint64_t value) {
+  unsigned count = 1;
+  for (;;) {
+    if (value < 10) return count;
+    if (value < 100) return count + 1;
+    if (value < 1000) return count + 2;
+    if (value < 10000) return count + 3;
+    value /= 10000;
+    count += 4;
+  }
+}
+
+// Writes the digits of value backwards, ending right before end
+inline void writeDigits(char* end, std::uint64_t value) {
+  while (value >= 100) {
+    end -= 2;
+    std::memcpy(end, kDigitPairs + (value % 100) * 2, 2);
+    value /= 100;
+  }
+  if (value >= 10) {
+    std::memcpy(end - 2, kDigitPairs + value * 2, 2);
+  } else {
+    end[-1] = char('0' + value);
+  }
+}
+
+// Converts 8 ASCII digits, the first one in the lowest byte, with three
+// multiplications: adjacent digits are merged into pairs, pairs into
+// quadruples and those into the result. Returns false on other characters.
+inline bool parseEightDigits(std::uint64_t chunk, std::uint32_t& value) {
+  const bool digits =
+      (chunk & 0xf0f0f0f0f0f0f0f0ull) == 0x3030303030303030ull &&
+      ((chunk + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) ==
+          0x3030303030303030ull;
+  chunk -= 0x3030303030303030ull;
+  chunk = (chunk * 10 + (chunk >> 8)) & 0x00ff00ff00ff00ffull;
+  chunk = (chunk * 100 + (chunk >> 16)) & 0x0000ffff0000ffffull;
+  chunk = chunk * 10000 + (chunk >> 32);
+  value = std::uint32_t(chunk);
+  return digits;
+}
+
+inline std::uint64_t loadDigits(const char* p) {
+  std::uint64_t chunk;
+  std::memcpy(&chunk, p, sizeof(chunk));
+  if constexpr (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) {
+    chunk = __builtin_bswap64(chunk);
+  }
+  return chunk;
+}
+
+// Parses the 16 digits of a buffer, which are left-padded with '0'
+inline std::optional<std::uint64_t> parseSixteenDigits(const char* p) {
+#ifdef IBEX_NUMBER_TEXT_SIMD
+  const __m128i digits = _mm_sub_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8('0'));
+  const __m128i valid =
+      _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+  if (_mm_movemask_epi8(valid) != 0xffff) return std::nullopt;
+
+  // Widen to 16 bits, then merge neighbours with multiply-add: pairs,
+  // quadruples, and finally the two halves of 8 digits
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ten = _mm_setr_epi16(10, 1, 10, 1, 10, 1, 10, 1);
+  const __m128i pairs =
+      _mm_packs_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(digits, zero), ten),
+                      _mm_madd_epi16(_mm_unpackhi_epi8(digits, zero), ten));
+  const __m128i quads =
+      _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  const __m128i halves =
+      _mm_madd_epi16(_mm_packs_epi32(quads, quads),
+                     _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  const std::uint64_t high = std::uint32_t(_mm_cvtsi128_si32(halves));
+  const std::uint64_t low =
+      std::uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(halves, 4)));
+  return high * 100000000 + low;
+#else
+  std::uint32_t high, low;
+  if (!parseEightDigits(loadDigits(p), high) ||
+      !parseEightDigits(loadDigits(p + 8), low)) {
+    return std::nullopt;
+  }
+  return std::uint64_t(high) * 100000000 + low;
+#endif
+}
+
+}  // namespace detail
+
+///
+/// @brief      Writes the decimal representation of value, with a leading
+///             '-' if negative. Two digits are produced per division from a
+///             table of "00" to "99".
+///
+/// @param      out    Destination with room for kMaxIntegerChars.
+///
+/// @return     The end of the written characters.
+///
+template <typename T,
+          typename = std::enable_if_t<std::is_integral_v<T> &&
+                                      !std::is_same_v<T, bool>>>
+char* formatInteger(char* out, T value) {
+  std::uint64_t magnitude = std::uint64_t(value);
+  if constexpr (std::is_signed_v<T>) {
+    if (value < 0) {
+      *out++ = '-';
+      magnitude = 0 - magnitude;
+    }
+  }
+  out += detail::countDigits(magnitude);
+  detail::writeDigits(out, magnitude);
+  return out;
+}
+
+///
+/// @brief      Writes exactly width digits of value, padded with leading zeros,
+///             e.g. for timestamps. Higher digits that do not fit are dropped.
+///
+/// @return     out + width.
+///
+inline char* formatDigits(char* out, std::uint64_t value, std::size_t width) {
+  char* const end = out + width;
+  char* p = end;
+  while (p - out >= 2) {
+    p -= 2;
+    std::memcpy(p, detail::kDigitPairs + (value % 100) * 2, 2);
+    value /= 100;
+  }
+  if (p != out) *out = char('0' + value % 10);
+  return end;
+}
+
+///
+/// @brief      Writes the shortest representation of value that parses back
+///             to the same value, in fixed or scientific notation, whichever
+///             is shorter. Implemented by std::to_chars (Ryu in libstdc++),
+///             which neither allocates nor reads the locale.
+///
+/// @param      out    Destination with room for kMaxFloatChars.
+///
+/// @return     The end of the written characters.
+///
+/// @tparam     T      float or double; a long double can need more than
+///                    kMaxFloatChars characters.
+///
+template <typename T,
+          typename = std::enable_if_t<std::is_same_v<T, float> ||
+                                      std::is_same_v<T, double>>>
+char* formatFloat(char* out, T value) {
+  return std::to_chars(out, out + kMaxFloatChars, value).ptr;
+}
+
+///
+/// @brief      Parses a field of exactly width decimal digits, e.g. a column
+///             of a fixed-width record. Up to 16 digits are converted at once
+///             with SSE2 multiply-adds, or 8 at a time in a 64-bit word on
+///             other platforms.
+///
+/// @param      p      First digit.
+/// @param      width  Number of digits, at most 19.
+///
+/// @return     The value, or nothing if the field has a non-digit character.
+///
+inline std::optional<std::uint64_t> parseDigits(const char* p,
+                                                std::size_t width) {
+  if (width <= 8) {
+    char padded[8];
+    std::memset(padded, '0', sizeof(padded));
+    std::memcpy(padded + 8 - width, p, width);
+    std::uint32_t value;
+    if (!detail::parseEightDigits(detail::loadDigits(padded), value)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  const std::size_t head = width > 16 ? width - 16 : 0;
+  char padded[16];
+  std::memset(padded, '0', sizeof(padded));
+  std::memcpy(padded + 16 - (width - head), p + head, width - head);
+  const auto tail = detail::parseSixteenDigits(padded);
+  if (head == 0 || !tail) return tail;
+
+  const auto high = parseDigits(p, head);
+  if (!high) return std::nullopt;
+  return *high * 10000000000000000ull + *tail;
+}
+
+///
+/// @brief      Parses a decimal integer that spans all of text, with a
+///             leading '-' for signed types. Leading zeros are allowed.
+///
+/// @return     The value, or nothing if text is not a number or the number
+///             does not fit T.
+///
+template <typename T,
+          typename = std::enable_if_t<std::is_integral_v<T> &&
+                                      !std::is_same_v<T, bool>>>
+std::optional<T> parseInteger(std::string_view text) {
+  bool negative = false;
+  if constexpr (std::is_signed_v<T>) {
+    if (!text.empty() && text.front() == '-') {
+      negative = true;
+      text.remove_prefix(1);
+    }
+  }
+  if (text.empty()) return std::nullopt;
+  const std::size_t zeros = text.find_first_not_of('0');
+  if (zeros == std::string_view::npos) return T(0);
+  text.remove_prefix(zeros);
+
+  std::uint64_t magnitude;
+  if (text.size() <= 19) {
+    const auto value = parseDigits(text.data(), text.size());
+    if (!value) return std::nullopt;
+    magnitude = *value;
+  } else if (text.size() == 20) {
+    const auto high = parseDigits(text.data(), 19);
+    const char last = text.back();
+    if (!high || last < '0' || last > '9' ||
+        __builtin_mul_overflow(*high, 10u, &magnitude) ||
+        __builtin_add_overflow(magnitude, unsigned(last - '0'), &magnitude)) {
+      return std::nullopt;
+    }
+  } else {
+    return std::nullopt;
+  }
+
+  using Unsigned = std::make_unsigned_t<T>;
+  constexpr std::uint64_t kMax = std::uint64_t(std::numeric_limits<T>::max());
+  if (negative) {
+    if (magnitude > kMax + 1) return std::nullopt;
+    return T(Unsigned(0 - magnitude));
+  }
+  if (magnitude > kMax) return std::nullopt;
+  return T(magnitude);
+}
+
+}  // namespace ibex
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <ibex/Storage.h>
+
+#include <functional>
+
+namespace ibex {
+
+namespace detail {
+
+template <typename Signature>
+struct SignatureTag {};
+
+// Root of the chain of erased call operators
+struct ErasedOverloadRoot {
+  virtual ~ErasedOverloadRoot() {}
+  virtual void moveInto(void*) = 0;
+  void call() = delete;
+};
+
+// Adds one pure virtual call operator to Base
+template <typename Base, typename Signature>
+struct ErasedOverload;
+
+template <typename Base, typename R, typename... Args>
+struct ErasedOverload<Base, R(Args...)> : Base {
+  using Base::call;
+  virtual R call(SignatureTag<R(Args...)>, Args...) = 0;
+};
+
+template <typename Base, typename... Signatures>
+struct ErasedOverloadChain {
+  using type = Base;
+};
+
+template <typename Base, typename Signature, typename... Signatures>
+struct ErasedOverloadChain<Base, Signature, Signatures...>
+    : ErasedOverloadChain<ErasedOverload<Base, Signature>, Signatures...> {};
+
+// Implements the call operator for one Signature on top of Base
+template <typename Derived, typename Base, typename Signature>
+struct OverloadTarget;
+
+template <typename Derived, typename Base, typename R, typename... Args>
+struct OverloadTarget<Derived, Base, R(Args...)> : Base {
+  R call(SignatureTag<R(Args...)>, Args... args) override {
+    return static_cast<Derived*>(this)->f(std::forward<Args>(args)...);
+  }
+};
+
+template <typename Derived, typename Base, typename... Signatures>
+struct OverloadTargetChain {
+  using type = Base;
+};
+
+template <typename Derived, typename Base, typename Signature,
+          typename... Signatures>
+struct OverloadTargetChain<Derived, Base, Signature, Signatures...>
+    : OverloadTargetChain<Derived, OverloadTarget<Derived, Base, Signature>,
+                          Signatures...> {};
+
+// Provides the public call operator for one Signature
+template <typename Derived, typename Signature>
+struct OverloadInvoker;
+
+template <typename Derived, typename R, typename... Args>
+struct OverloadInvoker<Derived, R(Args...)> {
+  R operator()(Args... args) const {
+    return static_cast<const Derived&>(*this).template invoke<R(Args...)>(
+        std::forward<Args>(args)...);
+  }
+};
+
+}  // namespace detail
+
+///
+/// @brief      Stores one callable target and invokes it through any of
+///             several signatures, like a set of ibex::Functions sharing one
+///             target. The target is stored once, all signatures dispatch
+///             through one vtable, and moving the OverloadedFunction moves the
+///             target once.
+///
+/// @tparam     Size        Maximal target size in bytes
+/// @tparam     Signatures  Call signatures, e.g. void(Request&), void(Close)
+///
+template <std::size_t Size, typename... Signatures>
+class OverloadedFunction final
+    : public detail::OverloadInvoker<OverloadedFunction<Size, Signatures...>,
+                                     Signatures>... {
+ private:
+  static_assert(sizeof...(Signatures) > 0,
+                "At least one signature is required (Signatures).");
+
+  template <typename, typename>
+  friend struct detail::OverloadInvoker;
+
+  // ---------------------------------------------------------------------------
+  // Child Classes: Target Wrappers
+  // ---------------------------------------------------------------------------
+
+  // Type erased target functor
+  using ErasedTarget =
+      typename detail::ErasedOverloadChain<detail::ErasedOverloadRoot,
+                                           Signatures...>::type;
+
+  // Holds a non-type-erased target
+  template <typename Functor>
+  struct Target final
+      : detail::OverloadTargetChain<Target<Functor>, ErasedTarget,
+                                    Signatures...>::type {
+    using functor_t = std::remove_reference_t<Functor>;
+    functor_t f;
+
+    Target(functor_t&& func) : f(std::move(func)) {}
+    Target(const functor_t& func) : f(func) {}
+    ~Target() override = default;
+
+    // Move contained target to a different memory location
+    void moveInto(void* destination) override {
+      new (destination) Target(std::move(f));
+    }
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  mutable ErasedStorage<ErasedTarget, Size> m_storage;
+  bool m_isValid{false};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  using detail::OverloadInvoker<OverloadedFunction, Signatures>::operator()...;
+
+  // Create an empty function
+  OverloadedFunction() = default;
+
+  ~OverloadedFunction() {
+    if (m_isValid) m_storage.destroy();
+  }
+
+  // Construct from a callable that accepts every signature
+  template <typename Functor,
+            typename = std::enable_if_t<!std::is_same_v<
+                std::decay_t<Functor>, OverloadedFunction>>>
+  OverloadedFunction(Functor&& f) : m_isValid{true} {
+    m_storage.template create<Target<Functor>>(std::forward<Functor>(f));
+  }
+
+  // Move construct from other OverloadedFunction
+  OverloadedFunction(OverloadedFunction&& other) {
+    moveFrom(std::move(other));
+  }
+
+  // Move assignment from other OverloadedFunction
+  OverloadedFunction& operator=(OverloadedFunction&& other) {
+    if (this != &other) {
+      moveFrom(std::move(other));
+    }
+    return *this;
+  }
+
+  // Check whether a valid function is stored.
+  operator bool() const { return m_isValid; }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  // Invoke the contained target. Throws if no valid target has been stored.
+  template <typename Signature, typename... Args>
+  decltype(auto) invoke(Args&&... args) const {
+    if (!m_isValid) throw std::bad_function_call{};
+    return m_storage.get().call(detail::SignatureTag<Signature>{},
+                                std::forward<Args>(args)...);
+  }
+
+  // Steal contents from other function
+  void moveFrom(OverloadedFunction&& other) {
+    clear();
+    if (other.m_isValid) {
+      other.m_storage.get().moveInto(m_storage.raw());
+      m_isValid = true;
+      other.clear();
+    }
+  }
+
+  // Cleanly destroy contained target
+  void clear() {
+    if (m_isValid) {
+      m_storage.destroy();
+      m_isValid = false;
+    }
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <ibex/IntCoding.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      An append-only vector of 32-bit integers stored bit-packed in
+///             blocks of 128. Every block keeps its smallest value and stores
+///             the others relative to it with as few bits as the largest one
+///             needs (frame of reference), so values that are clustered, e.g.
+///             timestamps, IDs or small counters, take a fraction of 4 bytes.
+///             Random access extracts a single value without decoding its
+///             block; decode() unpacks whole blocks for scans.
+///             The last, incomplete block is kept unpacked.
+///
+class PackedIntVector final {
+ private:
+  // ---------------------------------------------------------------------------
+  // Child Classes
+  // ---------------------------------------------------------------------------
+  struct Block {
+    std::uint32_t reference;  // Smallest value of the block
+    std::uint32_t offset;     // Position of the packed words in m_words
+    std::uint32_t bits;
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::vector<std::uint32_t> m_words;
+  std::vector<Block> m_blocks;
+  std::array<std::uint32_t, kPackedBlockSize> m_tail;
+  std::size_t m_tailSize{0};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  PackedIntVector() = default;
+
+  explicit PackedIntVector(const std::vector<std::uint32_t>& values) {
+    for (const std::uint32_t value : values) pushBack(value);
+  }
+
+  std::size_t size() const {
+    return m_blocks.size() * kPackedBlockSize + m_tailSize;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  // Bytes of the packed representation, including block headers
+  std::size_t bytesUsed() const {
+    return m_words.size() * sizeof(std::uint32_t) +
+           m_blocks.size() * sizeof(Block) + m_tailSize * sizeof(std::uint32_t);
+  }
+
+  void pushBack(std::uint32_t value) {
+    m_tail[m_tailSize++] = value;
+    if (m_tailSize == kPackedBlockSize) seal();
+  }
+
+  std::uint32_t operator[](std::size_t index) const {
+    const std::size_t block = index / kPackedBlockSize;
+    if (block == m_blocks.size()) return m_tail[index % kPackedBlockSize];
+    const Block& header = m_blocks[block];
+    return header.reference + unpackValue(m_words.data() + header.offset,
+                                          header.bits,
+                                          index % kPackedBlockSize);
+  }
+
+  std::uint32_t at(std::size_t index) const {
+    if (index >= size()) {
+      throw std::out_of_range("PackedIntVector: index out of range");
+    }
+    return (*this)[index];
+  }
+
+  std::uint32_t back() const { return (*this)[size() - 1]; }
+
+  void clear() {
+    m_words.clear();
+    m_blocks.clear();
+    m_tailSize = 0;
+  }
+
+  ///
+  /// @brief      Writes all values to out, a whole block at a time.
+  ///
+  /// @param      out   Destination for size() values.
+  ///
+  void decode(std::uint32_t* out) const {
+    for (const Block& header : m_blocks) {
+      unpackBlock(m_words.data() + header.offset, header.bits, out);
+      for (std::size_t i = 0; i < kPackedBlockSize; ++i) {
+        out[i] += header.reference;
+      }
+      out += kPackedBlockSize;
+    }
+    for (std::size_t i = 0; i < m_tailSize; ++i) out[i] = m_tail[i];
+  }
+
+  std::vector<std::uint32_t> toVector() const {
+    std::vector<std::uint32_t> values(size());
+    decode(values.data());
+    return values;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  // Pack the full tail into a new block
+  void seal() {
+    std::uint32_t reference = m_tail[0];
+    for (const std::uint32_t value : m_tail) {
+      if (value < reference) reference = value;
+    }
+    std::uint32_t spread = 0;
+    for (std::uint32_t& value : m_tail) {
+      value -= reference;
+      spread |= value;
+    }
+
+    const unsigned bits = bitWidth(spread);
+    const std::size_t offset = m_words.size();
+    m_words.resize(offset + packedBlockWords(bits));
+    packBlock(m_tail.data(), bits, m_words.data() + offset);
+    m_blocks.push_back(Block{reference, std::uint32_t(offset), bits});
+    m_tailSize = 0;
+  }
+};
+
+}  // namespace ibex
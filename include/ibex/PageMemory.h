@@ -0,0 +1,205 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace ibex {
+
+///
+/// @brief      How PageMemory should try to obtain huge pages.
+///
+enum class HugePages {
+  Off,          // Regular pages only
+  Transparent,  // madvise(MADV_HUGEPAGE) on a 2 MiB aligned mapping
+  Explicit,     // mmap(MAP_HUGETLB), falling back to Transparent
+};
+
+///
+/// @brief      Options for memory obtained directly from the kernel.
+///
+struct PageOptions {
+  HugePages hugePages{HugePages::Off};
+  bool prefault{false};  // Fault in all pages up front, e.g. at startup
+};
+
+///
+/// @brief      An anonymous memory mapping.
+///             Depending on PageOptions it is backed by explicit huge pages,
+///             transparent huge pages or regular pages. Requesting huge pages
+///             never fails: if the kernel has none to spare the mapping falls
+///             back to the next weaker kind, which backing() reports.
+///
+class PageMemory final {
+ public:
+  enum class Backing { None, Regular, Transparent, Explicit };
+
+  static constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+ private:
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  void* m_data{nullptr};
+  std::size_t m_size{0};
+  Backing m_backing{Backing::None};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  // Create an empty mapping
+  PageMemory() = default;
+
+  ///
+  /// @brief      Maps at least size bytes. Throws std::bad_alloc if the kernel
+  ///             refuses the mapping.
+  ///
+  /// @param      size     Requested size, rounded up to whole pages, or whole
+  ///                      huge pages if huge pages are requested.
+  /// @param      options  Huge page and prefault options.
+  ///
+  explicit PageMemory(std::size_t size, PageOptions options = {}) {
+    if (options.hugePages == HugePages::Explicit) {
+      m_size = roundUp(size, kHugePageSize);
+      int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+      if (options.prefault) flags |= MAP_POPULATE;
+      void* data =
+          ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+      if (data != MAP_FAILED) {
+        m_data = data;
+        m_backing = Backing::Explicit;
+        return;
+      }
+      options.hugePages = HugePages::Transparent;
+    }
+
+    if (options.hugePages == HugePages::Transparent) {
+      mapTransparent(size, options.prefault);
+    } else {
+      m_size = roundUp(size, pageSize());
+      int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+      if (options.prefault) flags |= MAP_POPULATE;
+      m_data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+      if (m_data == MAP_FAILED) fail();
+      m_backing = Backing::Regular;
+    }
+  }
+
+  PageMemory(PageMemory&& other)
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_backing(std::exchange(other.m_backing, Backing::None)) {}
+
+  PageMemory& operator=(PageMemory&& other) {
+    if (this != &other) {
+      release();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_backing = std::exchange(other.m_backing, Backing::None);
+    }
+    return *this;
+  }
+
+  ~PageMemory() { release(); }
+
+  void* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  Backing backing() const { return m_backing; }
+
+  ///
+  /// @brief      Number of bytes of this mapping that are currently backed by
+  ///             huge pages. For transparent huge pages this is read from
+  ///             /proc/self/smaps and only covers pages faulted in so far.
+  ///
+  std::size_t hugePageBytes() const {
+    switch (m_backing) {
+      case Backing::Explicit:
+        return m_size;
+      case Backing::Transparent:
+        return transparentHugePageBytes();
+      default:
+        return 0;
+    }
+  }
+
+  static std::size_t pageSize() {
+    static const std::size_t size = std::size_t(::sysconf(_SC_PAGESIZE));
+    return size;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  static std::size_t roundUp(std::size_t n, std::size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+  [[noreturn]] static void fail() { throw std::bad_alloc{}; }
+
+  // Map with room to align the start to a huge page, trim, then advise
+  void mapTransparent(std::size_t size, bool prefault) {
+    m_size = roundUp(size, kHugePageSize);
+    const std::size_t reserved = m_size + kHugePageSize;
+    void* raw = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) fail();
+
+    const auto begin = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = roundUp(begin, kHugePageSize);
+    if (aligned > begin) ::munmap(raw, aligned - begin);
+    const std::uintptr_t end = begin + reserved;
+    if (end > aligned + m_size) {
+      ::munmap(reinterpret_cast<void*>(aligned + m_size),
+               end - aligned - m_size);
+    }
+    m_data = reinterpret_cast<void*>(aligned);
+
+    m_backing = ::madvise(m_data, m_size, MADV_HUGEPAGE) == 0
+                    ? Backing::Transparent
+                    : Backing::Regular;
+
+    // MAP_POPULATE would fault in small pages before the advice takes effect
+    if (prefault) {
+      auto* bytes = static_cast<volatile unsigned char*>(m_data);
+      for (std::size_t i = 0; i < m_size; i += pageSize()) bytes[i] = 0;
+    }
+  }
+
+  // Reads AnonHugePages of the mapping containing m_data from smaps. If the
+  // kernel merged neighbouring mappings into it the result is capped.
+  std::size_t transparentHugePageBytes() const {
+    const auto address = reinterpret_cast<std::uintptr_t>(m_data);
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool inMapping = false;
+    while (std::getline(smaps, line)) {
+      unsigned long begin = 0;
+      unsigned long end = 0;
+      if (std::sscanf(line.c_str(), "%lx-%lx ", &begin, &end) == 2) {
+        inMapping = begin <= address && address < end;
+      } else if (inMapping && line.compare(0, 14, "AnonHugePages:") == 0) {
+        const std::size_t bytes = std::stoul(line.substr(14)) * 1024;
+        return bytes < m_size ? bytes : m_size;
+      }
+    }
+    return 0;
+  }
+
+  void release() {
+    if (m_data != nullptr) ::munmap(m_data, m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_backing = Backing::None;
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <ibex/PageMemory.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      A pool of fixed-size memory blocks carved from chunks of
+///             PageMemory. Freed blocks are kept in an intrusive free list and
+///             handed out again, so after warm-up allocation and deallocation
+///             are a few instructions each.
+///             Chunks can be backed by huge pages and prefaulted, see
+///             PageOptions. Not thread-safe.
+///
+class Pool final {
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::vector<PageMemory> m_chunks;
+  FreeBlock* m_free{nullptr};
+  std::size_t m_blockSize;
+  std::size_t m_blocksPerChunk;
+  PageOptions m_options;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Creates a pool. Chunks are mapped on demand, or up front by
+  ///             reserve().
+  ///
+  /// @param      blockSize       Size of each block. It is rounded up to a
+  ///                             multiple of alignof(std::max_align_t), which
+  ///                             is also the alignment of every block.
+  /// @param      blocksPerChunk  Number of blocks mapped at once.
+  /// @param      options         Huge page and prefault options.
+  ///
+  explicit Pool(std::size_t blockSize, std::size_t blocksPerChunk = 1024,
+                PageOptions options = {})
+      : m_blockSize(roundUp(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock)
+                                                          : blockSize)),
+        m_blocksPerChunk(blocksPerChunk),
+        m_options(options) {}
+
+  Pool(Pool&& other)
+      : m_chunks(std::move(other.m_chunks)),
+        m_free(std::exchange(other.m_free, nullptr)),
+        m_blockSize(other.m_blockSize),
+        m_blocksPerChunk(other.m_blocksPerChunk),
+        m_options(other.m_options) {}
+
+  Pool& operator=(Pool&& other) {
+    if (this != &other) {
+      m_chunks = std::move(other.m_chunks);
+      m_free = std::exchange(other.m_free, nullptr);
+      m_blockSize = other.m_blockSize;
+      m_blocksPerChunk = other.m_blocksPerChunk;
+      m_options = other.m_options;
+    }
+    return *this;
+  }
+
+  // Returns one block. Throws std::bad_alloc if no memory can be mapped.
+  void* allocate() {
+    if (m_free == nullptr) addChunk();
+    FreeBlock* block = m_free;
+    m_free = block->next;
+    return block;
+  }
+
+  // Returns a block obtained from allocate() to the pool
+  void deallocate(void* block) {
+    m_free = new (block) FreeBlock{m_free};
+  }
+
+  // Maps and, if requested, prefaults chunks for at least count more blocks
+  void reserve(std::size_t count) {
+    std::size_t available = 0;
+    for (FreeBlock* block = m_free; block != nullptr; block = block->next) {
+      ++available;
+    }
+    while (available < count) {
+      addChunk();
+      available += m_blocksPerChunk;
+    }
+  }
+
+  std::size_t blockSize() const { return m_blockSize; }
+
+  // Bytes mapped for this pool
+  std::size_t bytesReserved() const {
+    std::size_t bytes = 0;
+    for (const PageMemory& chunk : m_chunks) bytes += chunk.size();
+    return bytes;
+  }
+
+  // Bytes of the mapped chunks that are backed by huge pages
+  std::size_t hugePageBytes() const {
+    std::size_t bytes = 0;
+    for (const PageMemory& chunk : m_chunks) bytes += chunk.hugePageBytes();
+    return bytes;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  static std::size_t roundUp(std::size_t n) {
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+  // Map a chunk and thread all of its blocks onto the free list, in address
+  // order so that fresh blocks are handed out sequentially
+  void addChunk() {
+    m_chunks.emplace_back(m_blockSize * m_blocksPerChunk, m_options);
+    auto* bytes = static_cast<std::byte*>(m_chunks.back().data());
+    const std::size_t count = m_chunks.back().size() / m_blockSize;
+    for (std::size_t i = count; i-- > 0;) {
+      m_free = new (bytes + i * m_blockSize) FreeBlock{m_free};
+    }
+  }
+};
+
+}  // namespace ibex
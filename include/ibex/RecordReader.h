@@ -0,0 +1,352 @@
+#pragma once
+
+#include <ibex/FunctionRef.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define IBEX_RECORD_READER_SIMD 1
+#endif
+
+namespace ibex {
+
+namespace detail {
+
+// Calls f(offset) for every occurrence of c in [data, data + size), in order
+template <typename Visitor>
+void findAllScalar(const char* data, std::size_t size, char c, Visitor& f) {
+  const char* cursor = data;
+  const char* const end = data + size;
+  while (const void* match =
+             std::memchr(cursor, c, std::size_t(end - cursor))) {
+    const auto* position = static_cast<const char*>(match);
+    f(std::size_t(position - data));
+    cursor = position + 1;
+  }
+}
+
+#ifdef IBEX_RECORD_READER_SIMD
+
+// Compares 16 bytes at a time and visits the set bits of the match mask, so
+// dense matches such as short lines cost no extra call per match
+template <typename Visitor>
+void findAllSse2(const char* data, std::size_t size, char c, Visitor& f) {
+  const __m128i needle = _mm_set1_epi8(c);
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    auto mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+    while (mask != 0) {
+      f(i + std::size_t(__builtin_ctz(mask)));
+      mask &= mask - 1;
+    }
+  }
+  for (; i < size; ++i) {
+    if (data[i] == c) f(i);
+  }
+}
+
+template <typename Visitor>
+__attribute__((target("avx2"))) void findAllAvx2(const char* data,
+                                                 std::size_t size, char c,
+                                                 Visitor& f) {
+  const __m256i needle = _mm256_set1_epi8(c);
+  std::size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    auto mask =
+        unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+    while (mask != 0) {
+      f(i + std::size_t(__builtin_ctz(mask)));
+      mask &= mask - 1;
+    }
+  }
+  auto tail = [&](std::size_t offset) { f(i + offset); };
+  findAllSse2(data + i, size - i, c, tail);
+}
+
+inline bool hasAvx2() {
+  static const bool has = __builtin_cpu_supports("avx2");
+  return has;
+}
+
+#endif
+
+// Calls f(offset) for every occurrence of c, using the widest kernel the CPU
+// supports
+template <typename Visitor>
+void findAll(const char* data, std::size_t size, char c, Visitor&& f) {
+#ifdef IBEX_RECORD_READER_SIMD
+  if (hasAvx2()) {
+    findAllAvx2(data, size, c, f);
+  } else {
+    findAllSse2(data, size, c, f);
+  }
+#else
+  findAllScalar(data, size, c, f);
+#endif
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// Free Functions
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Calls f for every record of data, i.e. every piece terminated by
+///             delimiter, without the delimiter. A last record without a
+///             delimiter is passed as well.
+///
+/// @return     Number of records.
+///
+inline std::size_t forEachRecord(std::string_view data, char delimiter,
+                                 FunctionRef<void(std::string_view)> f) {
+  std::size_t start = 0;
+  std::size_t count = 0;
+  detail::findAll(data.data(), data.size(), delimiter, [&](std::size_t end) {
+    f(data.substr(start, end - start));
+    start = end + 1;
+    ++count;
+  });
+  if (start < data.size()) {
+    f(data.substr(start));
+    ++count;
+  }
+  return count;
+}
+
+///
+/// @brief      Calls f for every field of a record separated by delimiter,
+///             e.g. ',' for CSV. Quoting is not interpreted.
+///
+/// @return     Number of fields.
+///
+inline std::size_t splitFields(std::string_view record, char delimiter,
+                               FunctionRef<void(std::string_view)> f) {
+  std::size_t start = 0;
+  std::size_t count = 1;
+  detail::findAll(record.data(), record.size(), delimiter,
+                  [&](std::size_t end) {
+                    f(record.substr(start, end - start));
+                    start = end + 1;
+                    ++count;
+                  });
+  f(record.substr(start));
+  return count;
+}
+
+// ---------------------------------------------------------------------------
+// MappedFile
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      A file mapped read-only into memory and advised for sequential
+///             access, so the kernel reads ahead aggressively.
+///             Throws std::system_error if the file cannot be mapped.
+///
+class MappedFile final {
+ private:
+  const char* m_data{nullptr};
+  std::size_t m_size{0};
+
+ public:
+  explicit MappedFile(const std::string& path) {
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) fail("open " + path);
+    struct stat status;
+    if (::fstat(file, &status) != 0) {
+      const int error = errno;
+      ::close(file);
+      errno = error;
+      fail("fstat " + path);
+    }
+    m_size = std::size_t(status.st_size);
+    if (m_size > 0) {
+      void* mapping =
+          ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+      const int error = errno;
+      ::close(file);
+      if (mapping == MAP_FAILED) {
+        errno = error;
+        fail("mmap " + path);
+      }
+      m_data = static_cast<const char*>(mapping);
+      ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+    } else {
+      ::close(file);
+    }
+  }
+
+  MappedFile(MappedFile&& other)
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+  MappedFile& operator=(MappedFile&& other) {
+    if (this != &other) {
+      release();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { release(); }
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  std::string_view view() const { return {m_data, m_size}; }
+
+ private:
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(),
+                            "MappedFile: " + what);
+  }
+
+  void release() {
+    if (m_data != nullptr) ::munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// RecordReader
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Reads a file record by record, e.g. line by line, without
+///             copying: records are string_views into the mapped file, valid
+///             as long as the reader. Delimiters are found with SSE2 or, if the
+///             CPU supports it, AVX2.
+///
+class RecordReader final {
+ private:
+  MappedFile m_file;
+  char m_delimiter;
+
+ public:
+  using Batch = FunctionRef<void(const std::string_view*, std::size_t)>;
+  using ChunkVisitor = FunctionRef<void(std::size_t, std::string_view)>;
+
+  explicit RecordReader(const std::string& path, char delimiter = '\n')
+      : m_file(path), m_delimiter(delimiter) {}
+
+  std::string_view data() const { return m_file.view(); }
+
+  ///
+  /// @brief      Calls f for every record in file order.
+  ///
+  /// @return     Number of records.
+  ///
+  std::size_t forEach(FunctionRef<void(std::string_view)> f) const {
+    return forEachRecord(data(), m_delimiter, f);
+  }
+
+  ///
+  /// @brief      Calls f with batches of up to batchSize records, which
+  ///             amortizes the indirect call for very short records.
+  ///
+  /// @return     Number of records.
+  ///
+  std::size_t forEachBatch(Batch f, std::size_t batchSize = 256) const {
+    std::vector<std::string_view> batch;
+    batch.reserve(batchSize);
+    const std::size_t count =
+        forEachRecord(data(), m_delimiter, [&](std::string_view record) {
+          batch.push_back(record);
+          if (batch.size() == batchSize) {
+            f(batch.data(), batch.size());
+            batch.clear();
+          }
+        });
+    if (!batch.empty()) f(batch.data(), batch.size());
+    return count;
+  }
+
+  ///
+  /// @brief      Splits the file into chunks of about chunkSize bytes that end
+  ///             on a delimiter, and calls f(chunkIndex, record) for their
+  ///             records on several threads. Records of one chunk are visited
+  ///             in order by one thread; chunkIndex lets f shard its results.
+  ///             The first exception thrown by f is rethrown once all threads
+  ///             are done.
+  ///
+  /// @return     Number of records.
+  ///
+  std::size_t forEachParallel(
+      ChunkVisitor f,
+      std::size_t threads = std::thread::hardware_concurrency(),
+      std::size_t chunkSize = 8 * 1024 * 1024) const {
+    const std::vector<std::string_view> chunks = split(chunkSize);
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> count{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto work = [&] {
+      try {
+        for (std::size_t chunk = next++; chunk < chunks.size();
+             chunk = next++) {
+          count += forEachRecord(chunks[chunk], m_delimiter,
+                                 [&](std::string_view record) {
+                                   f(chunk, record);
+                                 });
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) error = std::current_exception();
+        next = chunks.size();
+      }
+    };
+
+    threads = std::max<std::size_t>(1, std::min(threads, chunks.size()));
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (auto& worker : workers) worker.join();
+    if (error) std::rethrow_exception(error);
+    return count;
+  }
+
+  // Chunks of about chunkSize bytes, each ending after a delimiter
+  std::vector<std::string_view> split(std::size_t chunkSize) const {
+    const std::string_view all = data();
+    std::vector<std::string_view> chunks;
+    std::size_t start = 0;
+    while (start < all.size()) {
+      std::size_t end = start + chunkSize;
+      if (end >= all.size()) {
+        end = all.size();
+      } else {
+        const std::size_t delimiter = all.find(m_delimiter, end - 1);
+        end = delimiter == std::string_view::npos ? all.size() : delimiter + 1;
+      }
+      chunks.push_back(all.substr(start, end - start));
+      start = end;
+    }
+    return chunks;
+  }
+};
+
+}  // namespace ibex
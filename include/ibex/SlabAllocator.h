@@ -0,0 +1,399 @@
+#pragma once
+
+#include <ibex/PageMemory.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ibex {
+
+namespace detail {
+
+// Block sizes of the SlabAllocator: multiples of 16 up to 128, above that four
+// steps per power of two, like the Function size classes.
+inline constexpr std::array<std::uint32_t, 21> kSlabSizeClasses{
+    8,   16,  32,  48,  64,  80,  96,  112, 128, 160, 192,
+    224, 256, 320, 384, 448, 512, 640, 768, 896, 1024};
+
+inline constexpr std::size_t kSlabMaxSize = 1024;
+
+// Size class index for every size in steps of 8
+constexpr std::array<std::uint8_t, kSlabMaxSize / 8 + 1> makeSlabClassTable() {
+  std::array<std::uint8_t, kSlabMaxSize / 8 + 1> table{};
+  std::size_t sizeClass = 0;
+  for (std::size_t i = 0; i < table.size(); ++i) {
+    while (kSlabSizeClasses[sizeClass] < i * 8) ++sizeClass;
+    table[i] = std::uint8_t(sizeClass);
+  }
+  return table;
+}
+
+inline constexpr auto kSlabClassTable = makeSlabClassTable();
+
+}  // namespace detail
+
+///
+/// @brief      A general allocator for small objects of 8 to 1024 bytes.
+///             Sizes are rounded up to one of 21 size classes. Every thread
+///             allocates from its own heap, which carves 64 KiB spans into
+///             blocks of one size class and keeps a free list per class, so
+///             the fast path takes no locks and no atomics.
+///             Blocks freed by another thread than the one that allocated
+///             them are pushed onto a lock-free list of the owning heap, which
+///             reclaims them in one batch once its local free list runs dry.
+///             Larger requests are passed on to an upstream resource.
+///
+///             Memory is only returned to the system when the allocator is
+///             destroyed. A thread hands its heap back when it exits, and the
+///             next thread that needs a heap adopts it with its free blocks.
+///
+class SlabAllocator final : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t kSpanSize = 64 * 1024;
+  static constexpr std::size_t kMaxSize = detail::kSlabMaxSize;
+
+ private:
+  static constexpr std::size_t kClassCount = detail::kSlabSizeClasses.size();
+  static constexpr std::size_t kRegionSize = 32 * kSpanSize;
+
+  // ---------------------------------------------------------------------------
+  // Child Classes
+  // ---------------------------------------------------------------------------
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct Heap;
+
+  // Start of every span, found by masking a block address
+  struct alignas(16) SpanHeader {
+    Heap* owner;
+    std::uint32_t sizeClass;
+  };
+
+  struct SizeClass {
+    FreeBlock* free{nullptr};
+    std::byte* bump{nullptr};  // Not yet carved part of the current span
+    std::byte* end{nullptr};
+  };
+
+  // Allocation state of one thread
+  struct Heap {
+    std::array<SizeClass, kClassCount> classes;
+    // Blocks freed by other threads; pushed by many, taken all at once by one
+    std::atomic<FreeBlock*> remote{nullptr};
+  };
+
+  // Heaps of all threads. Shared with the threads, which hand their heap
+  // back when they exit, even if that is after the allocator is destroyed.
+  struct HeapRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Heap>> heaps;
+    std::vector<Heap*> idle;  // Handed back, capacity for all heaps
+    Heap* detached{nullptr};  // Used under the mutex, see allocateDetached()
+  };
+
+  // Heap of the allocator the calling thread used last. Trivially
+  // destructible, so it stays readable while other thread_local objects,
+  // which may still allocate or deallocate, are destroyed.
+  struct LastHeap {
+    std::uint64_t instance;
+    Heap* heap;
+    bool exited;  // The thread has handed back its heaps
+  };
+
+  // The heaps the calling thread uses, by instance
+  struct ThreadState {
+    struct Entry {
+      std::weak_ptr<HeapRegistry> registry;
+      Heap* heap;
+    };
+
+    std::unordered_map<std::uint64_t, Entry> entries;
+    std::size_t pruneAt{16};
+
+    ~ThreadState() {
+      for (auto& [instance, entry] : entries) {
+        const std::shared_ptr<HeapRegistry> registry = entry.registry.lock();
+        if (!registry) continue;
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        registry->idle.push_back(entry.heap);
+      }
+      lastHeap() = LastHeap{0, nullptr, true};
+    }
+
+    // Forget the heaps of destroyed allocators, once entries doubled
+    void prune() {
+      if (entries.size() < pruneAt) return;
+      for (auto it = entries.begin(); it != entries.end();) {
+        it = it->second.registry.expired() ? entries.erase(it) : std::next(it);
+      }
+      pruneAt = 2 * entries.size() > 16 ? 2 * entries.size() : 16;
+    }
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::pmr::memory_resource* m_upstream;
+  PageOptions m_options;
+  const std::uint64_t m_instance;
+  std::shared_ptr<HeapRegistry> m_registry;
+
+  std::mutex m_mutex;  // Guards everything below, only taken for new spans
+  std::vector<PageMemory> m_regions;
+  std::byte* m_nextSpan{nullptr};
+  std::byte* m_regionEnd{nullptr};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  ///
+  /// @brief      Creates an allocator. Spans are mapped on demand, 2 MiB at a
+  ///             time.
+  ///
+  /// @param      upstream  Resource for requests larger than kMaxSize.
+  /// @param      options   Huge page and prefault options for the spans.
+  ///
+  explicit SlabAllocator(
+      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+      PageOptions options = {})
+      : m_upstream(upstream),
+        m_options(options),
+        m_instance(nextInstance()),
+        m_registry(std::make_shared<HeapRegistry>()) {}
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+  ///
+  /// @brief      Returns at least size bytes aligned to alignment. Throws
+  ///             std::bad_alloc if no memory can be obtained.
+  ///
+  void* allocate(std::size_t size,
+                 std::size_t alignment = alignof(std::max_align_t)) {
+    size = blockSize(size, alignment);
+    if (size > kMaxSize) return m_upstream->allocate(size, alignment);
+
+    const std::size_t sizeClass = detail::kSlabClassTable[(size + 7) / 8];
+    Heap* heap = localHeap();
+    if (heap == nullptr) return allocateDetached(sizeClass);
+    SizeClass& state = heap->classes[sizeClass];
+    if (FreeBlock* block = state.free) {
+      state.free = block->next;
+      return block;
+    }
+    return allocateSlow(*heap, sizeClass);
+  }
+
+  ///
+  /// @brief      Returns memory obtained from allocate() with the same size
+  ///             and alignment. Can be called from any thread.
+  ///
+  void deallocate(void* pointer, std::size_t size,
+                  std::size_t alignment = alignof(std::max_align_t)) {
+    size = blockSize(size, alignment);
+    if (size > kMaxSize) {
+      return m_upstream->deallocate(pointer, size, alignment);
+    }
+
+    FreeBlock* block = new (pointer) FreeBlock{nullptr};
+    const SpanHeader& span = spanOf(pointer);
+    Heap* heap = localHeap();
+    if (span.owner == heap) {
+      SizeClass& state = heap->classes[span.sizeClass];
+      block->next = state.free;
+      state.free = block;
+    } else {
+      std::atomic<FreeBlock*>& remote = span.owner->remote;
+      block->next = remote.load(std::memory_order_relaxed);
+      while (!remote.compare_exchange_weak(block->next, block,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+      }
+    }
+  }
+
+  // Bytes mapped for spans
+  std::size_t bytesMapped() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t bytes = 0;
+    for (const PageMemory& region : m_regions) bytes += region.size();
+    return bytes;
+  }
+
+  // ---------------------------------------------------------------------------
+  // std::pmr::memory_resource
+  // ---------------------------------------------------------------------------
+ private:
+  void* do_allocate(std::size_t size, std::size_t alignment) override {
+    return allocate(size, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t size,
+                     std::size_t alignment) override {
+    deallocate(pointer, size, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other)
+      const noexcept override {
+    return this == &other;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+  static std::uint64_t nextInstance() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+  }
+
+  // Blocks of the 8 byte class are 8 byte aligned and all others 16 byte
+  // aligned. Power of two classes are aligned to their size, so over-aligned
+  // requests are rounded up to one of them.
+  static std::size_t blockSize(std::size_t size, std::size_t alignment) {
+    if (alignment <= 8) return size == 0 ? 1 : size;
+    if (alignment <= 16) return size < 16 ? 16 : size;
+    std::size_t block = alignment;
+    while (block < size) block *= 2;
+    return block;
+  }
+
+  // Offset of the first block in a span, which aligns power of two blocks
+  static constexpr std::size_t firstBlock(std::size_t size) {
+    const std::size_t lowBit = size & (~size + 1);
+    return lowBit > sizeof(SpanHeader) ? lowBit : sizeof(SpanHeader);
+  }
+
+  static const SpanHeader& spanOf(void* pointer) {
+    const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+    return *std::launder(
+        reinterpret_cast<SpanHeader*>(address & ~(kSpanSize - 1)));
+  }
+
+  static LastHeap& lastHeap() {
+    thread_local LastHeap last{0, nullptr, false};
+    return last;
+  }
+
+  // Heap of the calling thread, nullptr if it has handed back its heaps
+  Heap* localHeap() {
+    LastHeap& last = lastHeap();
+    if (last.instance == m_instance) return last.heap;
+    if (last.exited) return nullptr;
+
+    thread_local ThreadState state;
+    auto found = state.entries.find(m_instance);
+    if (found == state.entries.end()) {
+      state.prune();
+      found = state.entries
+                  .emplace(m_instance,
+                           ThreadState::Entry{m_registry, acquireHeap()})
+                  .first;
+    }
+    last = LastHeap{m_instance, found->second.heap, false};
+    return last.heap;
+  }
+
+  // Adopt a heap handed back by an exited thread, or create one
+  Heap* acquireHeap() {
+    std::lock_guard<std::mutex> lock(m_registry->mutex);
+    if (!m_registry->idle.empty()) {
+      Heap* heap = m_registry->idle.back();
+      m_registry->idle.pop_back();
+      return heap;
+    }
+    return createHeap();
+  }
+
+  // Requires the registry mutex. Reserves room to hand the heap back, so
+  // that cannot fail when the thread exits.
+  Heap* createHeap() {
+    m_registry->idle.reserve(m_registry->heaps.size() + 1);
+    return m_registry->heaps.emplace_back(std::make_unique<Heap>()).get();
+  }
+
+  // Allocates on a thread that has handed back its heaps, from a heap that
+  // is only used under the registry mutex
+  void* allocateDetached(std::size_t sizeClass) {
+    std::lock_guard<std::mutex> lock(m_registry->mutex);
+    if (m_registry->detached == nullptr) m_registry->detached = createHeap();
+    Heap& heap = *m_registry->detached;
+    SizeClass& state = heap.classes[sizeClass];
+    if (FreeBlock* block = state.free) {
+      state.free = block->next;
+      return block;
+    }
+    return allocateSlow(heap, sizeClass);
+  }
+
+  // The free list of the size class is empty: reclaim remotely freed blocks,
+  // carve a block from the current span, or start a new span
+  void* allocateSlow(Heap& heap, std::size_t sizeClass) {
+    SizeClass& state = heap.classes[sizeClass];
+    if (heap.remote.load(std::memory_order_relaxed) != nullptr) {
+      reclaimRemote(heap);
+      if (FreeBlock* block = state.free) {
+        state.free = block->next;
+        return block;
+      }
+    }
+
+    const std::size_t size = detail::kSlabSizeClasses[sizeClass];
+    if (std::size_t(state.end - state.bump) >= size) {
+      void* block = state.bump;
+      state.bump += size;
+      return block;
+    }
+
+    std::byte* span = newSpan();
+    new (span) SpanHeader{&heap, std::uint32_t(sizeClass)};
+    state.bump = span + firstBlock(size) + size;
+    state.end = span + kSpanSize;
+    return span + firstBlock(size);
+  }
+
+  // Move all blocks freed by other threads onto the local free lists
+  static void reclaimRemote(Heap& heap) {
+    FreeBlock* block =
+        heap.remote.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr) {
+      FreeBlock* next = block->next;
+      SizeClass& state = heap.classes[spanOf(block).sizeClass];
+      block->next = state.free;
+      state.free = block;
+      block = next;
+    }
+  }
+
+  std::byte* newSpan() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_nextSpan == m_regionEnd) {
+      // Map one span more than needed so the spans can be aligned
+      PageMemory& region =
+          m_regions.emplace_back(kRegionSize + kSpanSize, m_options);
+      const auto begin = reinterpret_cast<std::uintptr_t>(region.data());
+      const std::uintptr_t end = begin + region.size();
+      m_nextSpan = reinterpret_cast<std::byte*>((begin + kSpanSize - 1) &
+                                                ~(kSpanSize - 1));
+      m_regionEnd = reinterpret_cast<std::byte*>(end & ~(kSpanSize - 1));
+    }
+    std::byte* span = m_nextSpan;
+    m_nextSpan += kSpanSize;
+    return span;
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,532 @@
+#pragma once
+
+#include <ibex/BufferChain.h>
+#include <ibex/EventLoop.h>
+#include <ibex/Function.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace ibex {
+
+// ---------------------------------------------------------------------------
+// SocketAddress
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      An IPv4 or IPv6 address and port.
+///
+class SocketAddress final {
+ private:
+  sockaddr_storage m_storage{};
+  socklen_t m_length{0};
+
+ public:
+  SocketAddress() = default;
+
+  ///
+  /// @brief      Parses a numeric address such as "127.0.0.1" or "::1".
+  ///             Throws std::invalid_argument if ip is not one.
+  ///
+  SocketAddress(const std::string& ip, std::uint16_t port) {
+    if (ip.find(':') == std::string::npos) {
+      auto& address = reinterpret_cast<sockaddr_in&>(m_storage);
+      address.sin_family = AF_INET;
+      address.sin_port = htons(port);
+      if (::inet_pton(AF_INET, ip.c_str(), &address.sin_addr) != 1) {
+        throw std::invalid_argument("SocketAddress: invalid address " + ip);
+      }
+      m_length = sizeof(sockaddr_in);
+    } else {
+      auto& address = reinterpret_cast<sockaddr_in6&>(m_storage);
+      address.sin6_family = AF_INET6;
+      address.sin6_port = htons(port);
+      if (::inet_pton(AF_INET6, ip.c_str(), &address.sin6_addr) != 1) {
+        throw std::invalid_argument("SocketAddress: invalid address " + ip);
+      }
+      m_length = sizeof(sockaddr_in6);
+    }
+  }
+
+  // 127.0.0.1; port 0 lets bind() pick a free port
+  static SocketAddress loopback(std::uint16_t port = 0) {
+    return SocketAddress("127.0.0.1", port);
+  }
+
+  const sockaddr* get() const {
+    return reinterpret_cast<const sockaddr*>(&m_storage);
+  }
+  sockaddr* get() { return reinterpret_cast<sockaddr*>(&m_storage); }
+
+  socklen_t length() const { return m_length; }
+  void setLength(socklen_t length) { m_length = length; }
+  static constexpr socklen_t capacity() { return sizeof(sockaddr_storage); }
+
+  int family() const { return m_storage.ss_family; }
+
+  std::uint16_t port() const {
+    if (family() == AF_INET) {
+      return ntohs(reinterpret_cast<const sockaddr_in&>(m_storage).sin_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in6&>(m_storage).sin6_port);
+  }
+
+  // Numeric address and port, e.g. "127.0.0.1:80" or "[::1]:80"
+  std::string toString() const {
+    char text[INET6_ADDRSTRLEN] = {};
+    if (family() == AF_INET) {
+      ::inet_ntop(AF_INET,
+                  &reinterpret_cast<const sockaddr_in&>(m_storage).sin_addr,
+                  text, sizeof(text));
+      return std::string(text) + ":" + std::to_string(port());
+    }
+    ::inet_ntop(AF_INET6,
+                &reinterpret_cast<const sockaddr_in6&>(m_storage).sin6_addr,
+                text, sizeof(text));
+    return "[" + std::string(text) + "]:" + std::to_string(port());
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Socket
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Owns a non-blocking socket descriptor. System call failures
+///             throw std::system_error.
+///
+class Socket final {
+ private:
+  int m_fd{-1};
+
+ public:
+  Socket() = default;
+  explicit Socket(int fd) : m_fd(fd) {}
+
+  Socket(int family, int type) {
+    m_fd = ::socket(family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0) fail("socket");
+  }
+
+  Socket(Socket&& other) : m_fd(std::exchange(other.m_fd, -1)) {}
+
+  Socket& operator=(Socket&& other) {
+    if (this != &other) {
+      close();
+      m_fd = std::exchange(other.m_fd, -1);
+    }
+    return *this;
+  }
+
+  ~Socket() { close(); }
+
+  int fd() const { return m_fd; }
+  explicit operator bool() const { return m_fd >= 0; }
+
+  void bind(const SocketAddress& address) {
+    if (::bind(m_fd, address.get(), address.length()) != 0) fail("bind");
+  }
+
+  void setOption(int level, int option, int value) {
+    if (::setsockopt(m_fd, level, option, &value, sizeof(value)) != 0) {
+      fail("setsockopt");
+    }
+  }
+
+  SocketAddress localAddress() const {
+    SocketAddress address;
+    socklen_t length = SocketAddress::capacity();
+    if (::getsockname(m_fd, address.get(), &length) != 0) {
+      fail("getsockname");
+    }
+    address.setLength(length);
+    return address;
+  }
+
+  void close() {
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+  }
+
+  [[noreturn]] static void fail(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Socket: " + what);
+  }
+};
+
+// ---------------------------------------------------------------------------
+// UDP
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      One datagram: its payload and the address it came from or
+///             goes to.
+///
+struct Datagram {
+  const std::byte* data;
+  std::size_t size;
+  SocketAddress peer;
+  bool truncated{false};  // Received payload was cut to the buffer size
+};
+
+///
+/// @brief      Preallocated buffers and message headers for receiving up to
+///             capacity() datagrams with one recvmmsg(). The received
+///             datagrams point into the batch and are valid until the next
+///             receive.
+///
+class DatagramBatch final {
+ private:
+  std::size_t m_datagramSize;
+  std::vector<std::byte> m_storage;
+  std::vector<iovec> m_vectors;
+  std::vector<mmsghdr> m_headers;
+  std::vector<Datagram> m_datagrams;
+  std::size_t m_size{0};
+
+ public:
+  ///
+  /// @param      capacity      Datagrams received at once.
+  /// @param      datagramSize  Buffer size per datagram; longer datagrams
+  ///                           are truncated.
+  ///
+  explicit DatagramBatch(std::size_t capacity = 64,
+                         std::size_t datagramSize = 2048)
+      : m_datagramSize(datagramSize),
+        m_storage(capacity * datagramSize),
+        m_vectors(capacity),
+        m_headers(capacity),
+        m_datagrams(capacity) {
+    for (std::size_t i = 0; i < capacity; ++i) {
+      m_vectors[i].iov_base = m_storage.data() + i * datagramSize;
+      m_vectors[i].iov_len = datagramSize;
+      m_datagrams[i].data = m_storage.data() + i * datagramSize;
+    }
+  }
+
+  DatagramBatch(const DatagramBatch&) = delete;
+  DatagramBatch& operator=(const DatagramBatch&) = delete;
+
+  std::size_t capacity() const { return m_headers.size(); }
+  std::size_t datagramSize() const { return m_datagramSize; }
+  std::size_t size() const { return m_size; }
+
+  const Datagram* data() const { return m_datagrams.data(); }
+  const Datagram* begin() const { return m_datagrams.data(); }
+  const Datagram* end() const { return m_datagrams.data() + m_size; }
+  const Datagram& operator[](std::size_t index) const {
+    return m_datagrams[index];
+  }
+
+ private:
+  friend class UdpSocket;
+
+  // Reset the headers, which recvmmsg() overwrites, for the next receive
+  mmsghdr* prepare() {
+    for (std::size_t i = 0; i < m_headers.size(); ++i) {
+      msghdr& header = m_headers[i].msg_hdr;
+      header = msghdr{};
+      header.msg_name = m_datagrams[i].peer.get();
+      header.msg_namelen = SocketAddress::capacity();
+      header.msg_iov = &m_vectors[i];
+      header.msg_iovlen = 1;
+    }
+    return m_headers.data();
+  }
+
+  void complete(std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const mmsghdr& header = m_headers[i];
+      Datagram& datagram = m_datagrams[i];
+      datagram.size = header.msg_len;
+      datagram.peer.setLength(header.msg_hdr.msg_namelen);
+      datagram.truncated = (header.msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+    m_size = count;
+  }
+};
+
+///
+/// @brief      A non-blocking UDP socket that sends and receives batches of
+///             datagrams with one sendmmsg() or recvmmsg() call each.
+///
+class UdpSocket final {
+ private:
+  Socket m_socket;
+  std::vector<iovec> m_sendVectors;
+  std::vector<mmsghdr> m_sendHeaders;
+
+ public:
+  // Bind to address, e.g. SocketAddress::loopback() for any free port
+  explicit UdpSocket(const SocketAddress& address)
+      : m_socket(address.family(), SOCK_DGRAM) {
+    m_socket.bind(address);
+  }
+
+  int fd() const { return m_socket.fd(); }
+  Socket& socket() { return m_socket; }
+  SocketAddress localAddress() const { return m_socket.localAddress(); }
+
+  ///
+  /// @brief      Receives up to batch.capacity() datagrams.
+  ///
+  /// @return     Number of datagrams received, 0 if none are waiting.
+  ///
+  std::size_t receive(DatagramBatch& batch) {
+    for (;;) {
+      const int count = ::recvmmsg(m_socket.fd(), batch.prepare(),
+                                   unsigned(batch.capacity()), 0, nullptr);
+      if (count >= 0) {
+        batch.complete(std::size_t(count));
+        return std::size_t(count);
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        batch.complete(0);
+        return 0;
+      }
+      if (errno != EINTR) Socket::fail("recvmmsg");
+    }
+  }
+
+  ///
+  /// @brief      Sends datagrams to their peers.
+  ///
+  /// @return     Number of datagrams sent, less than count if the socket
+  ///             buffer is full.
+  ///
+  std::size_t send(const Datagram* datagrams, std::size_t count) {
+    m_sendVectors.resize(count);
+    m_sendHeaders.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      m_sendVectors[i].iov_base = const_cast<std::byte*>(datagrams[i].data);
+      m_sendVectors[i].iov_len = datagrams[i].size;
+      msghdr& header = m_sendHeaders[i].msg_hdr;
+      header = msghdr{};
+      header.msg_name = const_cast<sockaddr*>(datagrams[i].peer.get());
+      header.msg_namelen = datagrams[i].peer.length();
+      header.msg_iov = &m_sendVectors[i];
+      header.msg_iovlen = 1;
+    }
+    std::size_t sent = 0;
+    while (sent < count) {
+      const int result = ::sendmmsg(m_socket.fd(), m_sendHeaders.data() + sent,
+                                    unsigned(count - sent), 0);
+      if (result > 0) {
+        sent += std::size_t(result);
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      } else if (errno != EINTR) {
+        Socket::fail("sendmmsg");
+      }
+    }
+    return sent;
+  }
+
+  // Send one datagram, false if the socket buffer is full
+  bool send(const void* data, std::size_t size, const SocketAddress& peer) {
+    const Datagram datagram{static_cast<const std::byte*>(data), size, peer};
+    return send(&datagram, 1) == 1;
+  }
+};
+
+///
+/// @brief      Watches a UdpSocket in an EventLoop, edge-triggered, and passes
+///             every batch of received datagrams to a handler. The handler
+///             is called with the datagrams of one recvmmsg() until the
+///             socket is drained.
+///
+/// @tparam     HandlerSize  Maximal size of the handler, see Function
+///
+template <std::size_t HandlerSize = 64>
+class UdpReceiver final {
+ public:
+  using Handler = Function<void(const Datagram*, std::size_t), HandlerSize>;
+
+ private:
+  EventLoop& m_loop;
+  UdpSocket& m_socket;
+  DatagramBatch m_batch;
+  Handler m_handler;
+
+ public:
+  UdpReceiver(EventLoop& loop, UdpSocket& socket, Handler handler,
+              std::size_t batchSize = 64, std::size_t datagramSize = 2048)
+      : m_loop(loop),
+        m_socket(socket),
+        m_batch(batchSize, datagramSize),
+        m_handler(std::move(handler)) {
+    m_loop.add(m_socket.fd(), EPOLLIN | EPOLLET,
+               [this](std::uint32_t) { drain(); });
+  }
+
+  UdpReceiver(const UdpReceiver&) = delete;
+  UdpReceiver& operator=(const UdpReceiver&) = delete;
+
+  ~UdpReceiver() { m_loop.remove(m_socket.fd()); }
+
+  // Receive until the socket is empty, as edge-triggered epoll requires
+  std::size_t drain() {
+    std::size_t total = 0;
+    while (const std::size_t count = m_socket.receive(m_batch)) {
+      m_handler(m_batch.data(), count);
+      total += count;
+    }
+    return total;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// TCP
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      A non-blocking TCP connection that writes BufferChains with
+///             gathering writes and reads into them without copying.
+///
+class TcpStream final {
+ private:
+  static constexpr std::size_t kMaxSlices = 64;  // Per system call
+
+  Socket m_socket;
+  bool m_eof{false};
+
+ public:
+  explicit TcpStream(Socket socket) : m_socket(std::move(socket)) {
+    m_socket.setOption(IPPROTO_TCP, TCP_NODELAY, 1);
+  }
+
+  ///
+  /// @brief      Connects to address. Throws std::system_error if the
+  ///             connection is refused or fails.
+  ///
+  static TcpStream connect(const SocketAddress& address) {
+    Socket socket(address.family(), SOCK_STREAM);
+    if (::connect(socket.fd(), address.get(), address.length()) != 0 &&
+        errno != EINPROGRESS) {
+      Socket::fail("connect");
+    }
+    // Wait for the handshake, so the stream is usable once returned
+    pollfd ready{socket.fd(), POLLOUT, 0};
+    while (::poll(&ready, 1, -1) < 0) {
+      if (errno != EINTR) Socket::fail("poll");
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    ::getsockopt(socket.fd(), SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+      errno = error;
+      Socket::fail("connect");
+    }
+    return TcpStream(std::move(socket));
+  }
+
+  int fd() const { return m_socket.fd(); }
+  Socket& socket() { return m_socket; }
+
+  // Whether the peer has closed its side
+  bool eof() const { return m_eof; }
+
+  ///
+  /// @brief      Writes as much of chain as the socket accepts, up to 64
+  ///             slices per sendmsg(), and removes the written bytes from it.
+  ///             Stops when the socket buffer is full; wait for EPOLLOUT and
+  ///             call again.
+  ///
+  /// @return     Number of bytes written.
+  ///
+  std::size_t write(BufferChain& chain) {
+    iovec vectors[kMaxSlices];
+    std::size_t total = 0;
+    while (!chain.empty()) {
+      msghdr header{};
+      header.msg_iov = vectors;
+      header.msg_iovlen = chain.toIovec(vectors, kMaxSlices);
+      const ssize_t written = ::sendmsg(m_socket.fd(), &header, MSG_NOSIGNAL);
+      if (written < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        Socket::fail("sendmsg");
+      }
+      chain.trimFront(std::size_t(written));
+      total += std::size_t(written);
+    }
+    return total;
+  }
+
+  ///
+  /// @brief      Reads everything available into the end of chain, until the
+  ///             socket is drained as edge-triggered epoll requires, or the
+  ///             peer closed the connection, see eof().
+  ///
+  /// @return     Number of bytes read.
+  ///
+  std::size_t read(BufferChain& chain) {
+    std::size_t total = 0;
+    while (!m_eof) {
+      const auto [buffer, size] = chain.prepare(1);
+      const ssize_t count = ::recv(m_socket.fd(), buffer, size, 0);
+      if (count < 0) {
+        chain.commit(0);
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        if (errno == EINTR) continue;
+        Socket::fail("recv");
+      }
+      chain.commit(std::size_t(count));
+      if (count == 0) m_eof = true;
+      total += std::size_t(count);
+    }
+    return total;
+  }
+
+  // Signal the peer that nothing more will be written
+  void shutdownWrite() { ::shutdown(m_socket.fd(), SHUT_WR); }
+};
+
+///
+/// @brief      A non-blocking listening TCP socket.
+///
+class TcpListener final {
+ private:
+  Socket m_socket;
+
+ public:
+  explicit TcpListener(const SocketAddress& address, int backlog = 128)
+      : m_socket(address.family(), SOCK_STREAM) {
+    m_socket.setOption(SOL_SOCKET, SO_REUSEADDR, 1);
+    m_socket.bind(address);
+    if (::listen(m_socket.fd(), backlog) != 0) Socket::fail("listen");
+  }
+
+  int fd() const { return m_socket.fd(); }
+  SocketAddress localAddress() const { return m_socket.localAddress(); }
+
+  // Accept a pending connection, nullopt if there is none
+  std::optional<TcpStream> accept() {
+    for (;;) {
+      const int fd =
+          ::accept4(m_socket.fd(), nullptr, nullptr,
+                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd >= 0) return TcpStream(Socket(fd));
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return std::nullopt;
+      if (errno != EINTR && errno != ECONNABORTED) Socket::fail("accept4");
+    }
+  }
+};
+
+}  // namespace ibex
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <ibex/Storage.h>
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace ibex {
+
+///
+/// @brief      A growable sequence whose elements never change their address.
+///             Elements live in fixed-size chunks of ibex::Storage, so growing
+///             only ever allocates a new chunk and never moves an element.
+///             Chunks emptied by popBack() are kept for reuse until
+///             shrinkToFit() is called.
+///
+/// @tparam     T          Element type
+/// @tparam     ChunkSize  Number of elements per chunk, must be a power of two
+///
+template <typename T, std::size_t ChunkSize = 64>
+class StableVector final {
+ private:
+  static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+                "Chunk size must be a power of two (ChunkSize).");
+
+  static constexpr std::size_t kMask = ChunkSize - 1;
+  static constexpr std::size_t kShift = [] {
+    std::size_t shift = 0;
+    while ((std::size_t{1} << shift) != ChunkSize) ++shift;
+    return shift;
+  }();
+
+  using Chunk = std::unique_ptr<Storage<T>[]>;
+
+  // ---------------------------------------------------------------------------
+  // Child Classes: Iterators
+  // ---------------------------------------------------------------------------
+
+  template <typename Value, typename Owner>
+  class Iterator {
+   private:
+    Owner* m_owner{nullptr};
+    std::size_t m_index{0};
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    Iterator() = default;
+    Iterator(Owner* owner, std::size_t index)
+        : m_owner(owner), m_index(index) {}
+
+    reference operator*() const { return (*m_owner)[m_index]; }
+    pointer operator->() const { return &(*m_owner)[m_index]; }
+
+    Iterator& operator++() {
+      ++m_index;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      ++m_index;
+      return previous;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return m_index == other.m_index;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+  };
+
+  // ---------------------------------------------------------------------------
+  // Members
+  // ---------------------------------------------------------------------------
+  std::vector<Chunk> m_chunks;
+  std::size_t m_size{0};
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  using iterator = Iterator<T, StableVector>;
+  using const_iterator = Iterator<const T, const StableVector>;
+
+  StableVector() = default;
+
+  StableVector(StableVector&& other)
+      : m_chunks(std::move(other.m_chunks)), m_size(other.m_size) {
+    other.m_size = 0;
+  }
+
+  StableVector& operator=(StableVector&& other) {
+    if (this != &other) {
+      clear();
+      m_chunks = std::move(other.m_chunks);
+      m_size = other.m_size;
+      other.m_size = 0;
+    }
+    return *this;
+  }
+
+  ~StableVector() { clear(); }
+
+  ///
+  /// @brief      Constructs a new element at the end.
+  ///             Allocates a chunk if the last one is full and there is no
+  ///             spare chunk left from earlier shrinking.
+  ///
+  /// @param      args  Arguments passed to the constructor.
+  ///
+  /// @return     Reference to the new element, valid until it is removed.
+  ///
+  template <typename... Args>
+  T& emplaceBack(Args&&... args) {
+    const std::size_t chunk = m_size >> kShift;
+    if (chunk == m_chunks.size()) {
+      m_chunks.emplace_back(new Storage<T>[ChunkSize]);
+    }
+    Storage<T>& slot = m_chunks[chunk][m_size & kMask];
+    slot.create(std::forward<Args>(args)...);
+    ++m_size;
+    return slot.get();
+  }
+
+  T& pushBack(const T& value) { return emplaceBack(value); }
+  T& pushBack(T&& value) { return emplaceBack(std::move(value)); }
+
+  // Destroy the last element. The chunk it was in is kept for reuse.
+  void popBack() {
+    --m_size;
+    slot(m_size).destroy();
+  }
+
+  // Destroy all elements. Chunks are kept for reuse.
+  void clear() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      forEachChunk([](T* data, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) data[i].~T();
+      });
+    }
+    m_size = 0;
+  }
+
+  // Make sure chunks for at least count elements are allocated
+  void reserve(std::size_t count) {
+    while ((m_chunks.size() << kShift) < count) {
+      m_chunks.emplace_back(new Storage<T>[ChunkSize]);
+    }
+  }
+
+  // Release all chunks that do not hold any element
+  void shrinkToFit() {
+    m_chunks.resize((m_size + kMask) >> kShift);
+    m_chunks.shrink_to_fit();
+  }
+
+  T& operator[](std::size_t index) { return slot(index).get(); }
+  const T& operator[](std::size_t index) const { return slot(index).get(); }
+
+  // Access an element. Throws if the index is out of range.
+  T& at(std::size_t index) {
+    if (index >= m_size) throw std::out_of_range("StableVector::at");
+    return (*this)[index];
+  }
+
+  // Access an element. Throws if the index is out of range.
+  const T& at(std::size_t index) const {
+    if (index >= m_size) throw std::out_of_range("StableVector::at");
+    return (*this)[index];
+  }
+
+  T& front() { return (*this)[0]; }
+  const T& front() const { return (*this)[0]; }
+  T& back() { return (*this)[m_size - 1]; }
+  const T& back() const { return (*this)[m_size - 1]; }
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  // Number of elements that fit without allocating a new chunk
+  std::size_t capacity() const { return m_chunks.size() << kShift; }
+
+  ///
+  /// @brief      Invokes f(T* data, std::size_t count) once per non-empty
+  ///             chunk, in order. Elements of one chunk are contiguous, so the
+  ///             inner loop of f can be vectorised.
+  ///
+  template <typename F>
+  void forEachChunk(F&& f) {
+    std::size_t remaining = m_size;
+    for (std::size_t c = 0; remaining > 0; ++c) {
+      const std::size_t count = remaining < ChunkSize ? remaining : ChunkSize;
+      f(&m_chunks[c][0].get(), count);
+      remaining -= count;
+    }
+  }
+
+  ///
+  /// @brief      Invokes f(const T* data, std::size_t count) once per
+  ///             non-empty chunk, in order.
+  ///
+  template <typename F>
+  void forEachChunk(F&& f) const {
+    std::size_t remaining = m_size;
+    for (std::size_t c = 0; remaining > 0; ++c) {
+      const std::size_t count = remaining < ChunkSize ? remaining : ChunkSize;
+      f(&m_chunks[c][0].get(), count);
+      remaining -= count;
+    }
+  }
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, m_size}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, m_size}; }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  Storage<T>& slot(std::size_t index) {
+    return m_chunks[index >> kShift][index & kMask];
+  }
+
+  const Storage<T>& slot(std::size_t index) const {
+    return m_chunks[index >> kShift][index & kMask];
+  }
+};
+
+}  // namespace ibex
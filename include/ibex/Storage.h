@@ -1,10 +1,33 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace ibex {
 
+// ---------------------------------------------------------------------------
+// Traits
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Whether objects of type T may be moved to a different address
+///             by copying their bytes and not running the destructor on the
+///             source. Containers use this to replace move + destroy loops by
+///             memcpy.
+///             Defaults to std::is_trivially_copyable; specialise for types
+///             that are known to be relocatable.
+///
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
 // ---------------------------------------------------------------------------
 // Storage
 // ---------------------------------------------------------------------------
@@ -140,4 +163,82 @@ class ErasedStorage {
   void* raw() { return &get(); }
 };
 
+// ---------------------------------------------------------------------------
+// UnionStorage
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Uninitialised storage for exactly one of several types.
+///             Which type is currently alive has to be tracked by the user.
+///             This is mainly useful as a building block for sum types.
+///
+/// @tparam     Ts    Types that can be stored inside UnionStorage.
+///
+template <typename... Ts>
+class UnionStorage {
+ private:
+  static_assert(sizeof...(Ts) > 0, "UnionStorage needs at least one type.");
+
+  alignas(Ts...) std::array<std::byte, std::max({sizeof(Ts)...})> m_storage;
+
+  template <typename T>
+  static constexpr void checkType() {
+    static_assert((std::is_same_v<T, Ts> || ...),
+                  "Type must be one of the types of this UnionStorage (Ts).");
+  }
+
+ public:
+  ///
+  /// @brief      Constructs an object of type T within its storage.
+  ///
+  /// @param      args  Arguments passed to the constructor.
+  ///
+  template <typename T, typename... Args>
+  void create(Args&&... args) {
+    checkType<T>();
+    new (&m_storage) T(std::forward<Args>(args)...);
+  }
+
+  ///
+  /// @brief      Call destructor on contained element of type T.
+  ///
+  template <typename T>
+  void destroy() {
+    get<T>().~T();
+  }
+
+  /// Returns
+  ///
+  /// @return     A reference to the stored value.
+  ///
+  /// @note       Calling this function with a different type than the one
+  ///             last passed to 'create()' is undefined behaviour.
+  ///
+  template <typename T>
+  T& get() {
+    checkType<T>();
+    return *std::launder(reinterpret_cast<T*>(&m_storage));
+  }
+
+  /// Returns
+  ///
+  /// @return     A reference to the stored value.
+  ///
+  /// @note       Calling this function with a different type than the one
+  ///             last passed to 'create()' is undefined behaviour.
+  ///
+  template <typename T>
+  const T& get() const {
+    checkType<T>();
+    return *std::launder(reinterpret_cast<T const*>(&m_storage));
+  }
+
+  ///
+  /// @brief      Access the raw memory of the storage
+  ///
+  /// @return     Erased pointer to the storage.
+  ///
+  void* raw() { return &m_storage; }
+};
+
 }  // namespace ibex
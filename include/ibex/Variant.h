@@ -0,0 +1,440 @@
+#pragma once
+
+#include <ibex/Storage.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace ibex {
+
+template <typename... Ts>
+class Variant;
+
+namespace detail {
+
+// ---------------------------------------------------------------------------
+// Index Dispatch
+// ---------------------------------------------------------------------------
+
+// Up to this many alternatives visitation is a chain of compares, which
+// compilers turn into a few well predicted branches or cmovs. Above it a
+// table of function pointers indexed by the alternative is used.
+inline constexpr std::size_t kVariantIfChainMax = 4;
+
+// visitBatch sorts this many elements at a time in a buffer on the stack
+inline constexpr std::size_t kVariantBatchSize = 512;
+
+// Smallest unsigned type able to hold all values in [0, Count]
+template <std::size_t Count>
+using SmallestIndex = std::conditional_t<
+    (Count <= std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+    std::conditional_t<(Count <= std::numeric_limits<std::uint16_t>::max()),
+                       std::uint16_t, std::uint32_t>>;
+
+template <typename T, typename... Ts>
+constexpr std::size_t indexOf() {
+  constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+  for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+    if (matches[i]) return i;
+  }
+  return sizeof...(Ts);
+}
+
+template <typename R, typename F, std::size_t I>
+R invokeAt(F& f) {
+  return f(std::integral_constant<std::size_t, I>{});
+}
+
+template <typename R, typename F, std::size_t I, std::size_t Last>
+R dispatchChain(std::size_t index, F& f) {
+  if constexpr (I == Last) {
+    return invokeAt<R, F, I>(f);
+  } else {
+    if (index == I) return invokeAt<R, F, I>(f);
+    return dispatchChain<R, F, I + 1, Last>(index, f);
+  }
+}
+
+template <typename R, typename F, std::size_t... Is>
+R dispatchTable(std::size_t index, F& f, std::index_sequence<Is...>) {
+  static constexpr R (*table[])(F&) = {&invokeAt<R, F, Is>...};
+  return table[index](f);
+}
+
+template <typename F, std::size_t... Is>
+void forEachIndex(F&& f, std::index_sequence<Is...>) {
+  (f(std::integral_constant<std::size_t, Is>{}), ...);
+}
+
+// Calls f(std::integral_constant<std::size_t, I>{}) for every I in [0, Count)
+template <std::size_t Count, typename F>
+void forEachIndex(F&& f) {
+  forEachIndex(f, std::make_index_sequence<Count>{});
+}
+
+// Calls f(std::integral_constant<std::size_t, index>{}) for an index in
+// [0, Count). Every instantiation of f must return R.
+template <std::size_t Count, typename R, typename F>
+R dispatchIndex(std::size_t index, F&& f) {
+  if constexpr (Count <= kVariantIfChainMax + 1) {
+    return dispatchChain<R, F, 0, Count - 1>(index, f);
+  } else {
+    return dispatchTable<R>(index, f, std::make_index_sequence<Count>{});
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Variant Base: Special Member Functions
+// ---------------------------------------------------------------------------
+
+// Trivially copyable alternatives: every special member is trivial, so the
+// Variant is trivially copyable itself.
+template <bool Trivial, typename... Ts>
+class VariantBase {
+ protected:
+  using index_t = SmallestIndex<sizeof...(Ts)>;
+  static constexpr std::size_t npos = sizeof...(Ts);
+
+  UnionStorage<Ts...> m_storage;
+  index_t m_index;
+
+  template <std::size_t I>
+  using alternative_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+};
+
+// Any other alternatives: copy, move and destroy the active element.
+template <typename... Ts>
+class VariantBase<false, Ts...> {
+ protected:
+  using index_t = SmallestIndex<sizeof...(Ts)>;
+  static constexpr std::size_t npos = sizeof...(Ts);
+
+  UnionStorage<Ts...> m_storage;
+  index_t m_index{static_cast<index_t>(npos)};
+
+  template <std::size_t I>
+  using alternative_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+ public:
+  VariantBase() = default;
+
+  VariantBase(const VariantBase& other) { copyFrom(other); }
+
+  VariantBase(VariantBase&& other) noexcept(
+      (std::is_nothrow_move_constructible_v<Ts> && ...)) {
+    moveFrom(std::move(other));
+  }
+
+  VariantBase& operator=(const VariantBase& other) {
+    if (this != &other) {
+      reset();
+      copyFrom(other);
+    }
+    return *this;
+  }
+
+  VariantBase& operator=(VariantBase&& other) noexcept(
+      (std::is_nothrow_move_constructible_v<Ts> && ...)) {
+    if (this != &other) {
+      reset();
+      moveFrom(std::move(other));
+    }
+    return *this;
+  }
+
+  ~VariantBase() { reset(); }
+
+ protected:
+  // Destroy the active element, leaves the variant valueless
+  void reset() {
+    dispatchIndex<npos + 1, void>(m_index, [this](auto i) {
+      if constexpr (i != npos) {
+        m_storage.template destroy<alternative_t<i>>();
+      }
+    });
+    m_index = static_cast<index_t>(npos);
+  }
+
+ private:
+  void copyFrom(const VariantBase& other) {
+    dispatchIndex<npos + 1, void>(other.m_index, [&](auto i) {
+      if constexpr (i != npos) {
+        using T = alternative_t<i>;
+        m_storage.template create<T>(other.m_storage.template get<T>());
+      }
+    });
+    m_index = other.m_index;
+  }
+
+  void moveFrom(VariantBase&& other) {
+    dispatchIndex<npos + 1, void>(other.m_index, [&](auto i) {
+      if constexpr (i != npos) {
+        using T = alternative_t<i>;
+        m_storage.template create<T>(
+            std::move(other.m_storage.template get<T>()));
+      }
+    });
+    m_index = other.m_index;
+  }
+};
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// Variant
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      A tagged union similar to std::variant.
+///             It differs from std::variant in the following aspects:
+///             - The index uses the smallest unsigned type that can hold all
+///               alternatives, i.e. a single byte for up to 254 types.
+///             - Visitation is an if-chain for few alternatives and a jump
+///               table otherwise. The valueless state is part of the table,
+///               so there is no separate check on the visit path.
+///             - Variants of trivially copyable types are trivially copyable,
+///               variants of trivially relocatable types are trivially
+///               relocatable.
+///             - Alternatives are only selected by exact (decayed) type.
+///
+/// @tparam     Ts    Alternative types, each type may only appear once.
+///
+template <typename... Ts>
+class Variant final
+    : public detail::VariantBase<(std::is_trivially_copyable_v<Ts> && ...),
+                                 Ts...> {
+ private:
+  using Base =
+      detail::VariantBase<(std::is_trivially_copyable_v<Ts> && ...), Ts...>;
+  using index_t = typename Base::index_t;
+
+  template <typename T>
+  static constexpr std::size_t index_of = detail::indexOf<T, Ts...>();
+
+  template <typename T>
+  static constexpr bool is_alternative = index_of<T> != sizeof...(Ts);
+
+  template <typename T>
+  using enable_if_alternative_t = std::enable_if_t<
+      is_alternative<std::decay_t<T>> &&
+      !std::is_same_v<std::decay_t<T>, Variant>>;
+
+  // ---------------------------------------------------------------------------
+  // Public Functions
+  // ---------------------------------------------------------------------------
+ public:
+  /// Index of the valueless state
+  static constexpr std::size_t npos = sizeof...(Ts);
+
+  // Create a variant holding a value initialised first alternative
+  Variant() { emplace<typename Base::template alternative_t<0>>(); }
+
+  // Create a variant holding the given value
+  template <typename T, typename = enable_if_alternative_t<T>>
+  Variant(T&& value) {
+    emplace<std::decay_t<T>>(std::forward<T>(value));
+  }
+
+  // Create a variant holding a T constructed from args
+  template <typename T, typename... Args>
+  explicit Variant(std::in_place_type_t<T>, Args&&... args) {
+    emplace<T>(std::forward<Args>(args)...);
+  }
+
+  // Replace the current value by the given value
+  template <typename T, typename = enable_if_alternative_t<T>>
+  Variant& operator=(T&& value) {
+    emplace<std::decay_t<T>>(std::forward<T>(value));
+    return *this;
+  }
+
+  ///
+  /// @brief      Destroys the current value and constructs a new T in place.
+  ///             If the constructor throws the variant is left valueless.
+  ///
+  /// @param      args  Arguments passed to the constructor.
+  ///
+  /// @return     Reference to the new value.
+  ///
+  template <typename T, typename... Args>
+  T& emplace(Args&&... args) {
+    static_assert(is_alternative<T>, "Type must be an alternative (Ts).");
+    destroy();
+    this->m_index = static_cast<index_t>(npos);
+    this->m_storage.template create<T>(std::forward<Args>(args)...);
+    this->m_index = static_cast<index_t>(index_of<T>);
+    return this->m_storage.template get<T>();
+  }
+
+  // Zero-based index of the active alternative, npos if valueless
+  std::size_t index() const { return this->m_index; }
+
+  // Check whether a constructor threw during emplace
+  bool valueless() const { return this->m_index == npos; }
+
+  // Check whether T is the active alternative
+  template <typename T>
+  bool holds() const {
+    static_assert(is_alternative<T>, "Type must be an alternative (Ts).");
+    return this->m_index == index_of<T>;
+  }
+
+  // Access the value. Throws if T is not the active alternative.
+  template <typename T>
+  T& get() {
+    if (!holds<T>()) throw std::bad_variant_access{};
+    return this->m_storage.template get<T>();
+  }
+
+  // Access the value. Throws if T is not the active alternative.
+  template <typename T>
+  const T& get() const {
+    if (!holds<T>()) throw std::bad_variant_access{};
+    return this->m_storage.template get<T>();
+  }
+
+  // Access the value without checking the active alternative.
+  // Calling this with a T other than the active alternative is undefined
+  // behaviour.
+  template <typename T>
+  T& getUnchecked() {
+    return this->m_storage.template get<T>();
+  }
+
+  // Access the value without checking the active alternative.
+  // Calling this with a T other than the active alternative is undefined
+  // behaviour.
+  template <typename T>
+  const T& getUnchecked() const {
+    return this->m_storage.template get<T>();
+  }
+
+  // Access the value. Returns nullptr if T is not the active alternative.
+  template <typename T>
+  T* getIf() {
+    return holds<T>() ? &this->m_storage.template get<T>() : nullptr;
+  }
+
+  // Access the value. Returns nullptr if T is not the active alternative.
+  template <typename T>
+  const T* getIf() const {
+    return holds<T>() ? &this->m_storage.template get<T>() : nullptr;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Private Functions
+  // ---------------------------------------------------------------------------
+ private:
+  // Destroy the current value, if destruction is not a no-op anyway
+  void destroy() {
+    if constexpr (!(std::is_trivially_destructible_v<Ts> && ...)) {
+      this->reset();
+    }
+  }
+};
+
+template <typename... Ts>
+struct is_trivially_relocatable<Variant<Ts...>>
+    : std::bool_constant<(is_trivially_relocatable_v<Ts> && ...)> {};
+
+// ---------------------------------------------------------------------------
+// Visitation
+// ---------------------------------------------------------------------------
+
+///
+/// @brief      Invokes vis with the active alternative of v.
+///             Throws std::bad_variant_access if v is valueless.
+///
+/// @return     Result of vis, which must be the same for all alternatives.
+///
+template <typename Visitor, typename... Ts>
+decltype(auto) visit(Visitor&& vis, Variant<Ts...>& v) {
+  using R =
+      std::invoke_result_t<Visitor, std::tuple_element_t<0, std::tuple<Ts...>>&>;
+  return detail::dispatchIndex<sizeof...(Ts) + 1, R>(
+      v.index(), [&](auto i) -> R {
+        if constexpr (i == sizeof...(Ts)) {
+          throw std::bad_variant_access{};
+        } else {
+          using T = std::tuple_element_t<i, std::tuple<Ts...>>;
+          return std::forward<Visitor>(vis)(v.template getUnchecked<T>());
+        }
+      });
+}
+
+///
+/// @brief      Invokes vis with the active alternative of v.
+///             Throws std::bad_variant_access if v is valueless.
+///
+/// @return     Result of vis, which must be the same for all alternatives.
+///
+template <typename Visitor, typename... Ts>
+decltype(auto) visit(Visitor&& vis, const Variant<Ts...>& v) {
+  using R = std::invoke_result_t<
+      Visitor, const std::tuple_element_t<0, std::tuple<Ts...>>&>;
+  return detail::dispatchIndex<sizeof...(Ts) + 1, R>(
+      v.index(), [&](auto i) -> R {
+        if constexpr (i == sizeof...(Ts)) {
+          throw std::bad_variant_access{};
+        } else {
+          using T = std::tuple_element_t<i, std::tuple<Ts...>>;
+          return std::forward<Visitor>(vis)(v.template getUnchecked<T>());
+        }
+      });
+}
+
+///
+/// @brief      Invokes vis on every element of an array of variants.
+///             Elements are bucketed by their active alternative, up to
+///             kVariantBatchSize at a time, and then visited one alternative
+///             at a time, so each inner loop calls vis with a statically known
+///             type. The relative order of elements holding the same
+///             alternative is preserved; valueless elements are skipped.
+///             Nothing is allocated.
+///
+/// @param      vis    Callable accepting every alternative, return is ignored.
+/// @param      first  Pointer to the first variant.
+/// @param      count  Number of variants.
+///
+template <typename Visitor, typename... Ts>
+void visitBatch(Visitor&& vis, Variant<Ts...>* first, std::size_t count) {
+  constexpr std::size_t npos = Variant<Ts...>::npos;
+  using position_t = detail::SmallestIndex<detail::kVariantBatchSize>;
+
+  while (count > 0) {
+    const std::size_t size = std::min(count, detail::kVariantBatchSize);
+
+    // Counting sort of the element positions by alternative.
+    // Afterwards bucket a is order[offsets[a], offsets[a + 1]).
+    std::size_t offsets[npos + 1] = {};
+    for (std::size_t i = 0; i < size; ++i) {
+      const std::size_t a = first[i].index();
+      if (a != npos) ++offsets[a + 1];
+    }
+    for (std::size_t a = 1; a <= npos; ++a) offsets[a] += offsets[a - 1];
+
+    std::size_t cursor[npos];
+    std::copy(offsets, offsets + npos, cursor);
+    position_t order[detail::kVariantBatchSize];
+    for (std::size_t i = 0; i < size; ++i) {
+      const std::size_t a = first[i].index();
+      if (a != npos) order[cursor[a]++] = position_t(i);
+    }
+
+    detail::forEachIndex<npos>([&](auto a) {
+      using T = std::tuple_element_t<a, std::tuple<Ts...>>;
+      for (std::size_t k = offsets[a]; k < offsets[a + 1]; ++k) {
+        vis(first[order[k]].template getUnchecked<T>());
+      }
+    });
+    first += size;
+    count -= size;
+  }
+}
+
+}  // namespace ibex
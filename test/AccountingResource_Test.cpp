@@ -0,0 +1,90 @@
+#include <ibex/AccountingResource.h>
+#include <ibex/Arena.h>
+#include <ibex/SlabAllocator.h>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("AccountingResource Counts allocations and live bytes.") {
+  ibex::MemoryTag tag("test");
+  ibex::SlabAllocator slab;
+  ibex::AccountingResource sut(tag, &slab);
+
+  void* a = sut.allocate(100);
+  void* b = sut.allocate(200);
+  sut.deallocate(a, 100);
+
+  const auto stats = tag.stats();
+  REQUIRE(stats.allocations == 2);
+  REQUIRE(stats.deallocations == 1);
+  REQUIRE(stats.liveBytes == 200);
+  REQUIRE(stats.peakBytes >= 200);
+  sut.deallocate(b, 200);
+  REQUIRE(tag.stats().liveBytes == 0);
+}
+
+TEST_CASE("AccountingResource Peak bytes are tracked.") {
+  ibex::MemoryTag tag("test");
+  ibex::Arena arena;
+  ibex::AccountingResource sut(tag, &arena);
+
+  for (int i = 0; i < 3; ++i) {
+    void* block = sut.allocate(1 << 20);
+    sut.deallocate(block, 1 << 20);
+  }
+  const auto stats = tag.stats();
+  REQUIRE(stats.liveBytes == 0);
+  REQUIRE(stats.peakBytes == 1 << 20);
+}
+
+TEST_CASE("AccountingResource Tags include their children.") {
+  ibex::MemoryTag net("net");
+  ibex::MemoryTag buffers("buffers", &net);
+  ibex::MemoryTag sessions("sessions", &net);
+  ibex::AccountingResource bufferResource(buffers);
+  ibex::AccountingResource sessionResource(sessions);
+
+  REQUIRE(sessions.path() == "net/sessions");
+  REQUIRE(net.children().size() == 2);
+
+  std::pmr::vector<char> buffer(1000, &bufferResource);
+  std::pmr::vector<char> session(500, &sessionResource);
+  REQUIRE(buffers.stats().liveBytes == 1000);
+  REQUIRE(net.stats().liveBytes == 1500);
+  REQUIRE(net.stats().allocations == 2);
+
+  {
+    ibex::MemoryTag temporary("temporary", &net);
+    REQUIRE(net.children().size() == 3);
+  }
+  REQUIRE(net.children().size() == 2);
+}
+
+TEST_CASE("AccountingResource Counters are summed over threads.") {
+  ibex::MemoryTag tag("test");
+  ibex::AccountingResource sut(tag);
+  constexpr int count = 10000;
+
+  std::vector<std::vector<void*>> blocks(8);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < count; ++i) blocks[t].push_back(sut.allocate(16));
+      for (int i = 0; i < count / 2; ++i) sut.deallocate(blocks[t][i], 16);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  const auto stats = tag.stats();
+  REQUIRE(stats.allocations == 8 * count);
+  REQUIRE(stats.deallocations == 8 * count / 2);
+  REQUIRE(stats.liveBytes == 8 * count / 2 * 16);
+  REQUIRE(stats.peakBytes >= stats.liveBytes);
+
+  for (auto& perThread : blocks) {
+    for (int i = count / 2; i < count; ++i) sut.deallocate(perThread[i], 16);
+  }
+  REQUIRE(tag.stats().liveBytes == 0);
+}
@@ -0,0 +1,93 @@
+#include <ibex/BufferChain.h>
+
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+#include <string>
+
+TEST_CASE("BufferChain Appended bytes span blocks.") {
+  ibex::BufferPool pool(80, 4);
+  ibex::BufferChain sut(pool);
+  REQUIRE(pool.blockCapacity() == 64);
+
+  const std::string text(200, 'x');
+  sut.append(text);
+  sut.append("yz", 2);
+  REQUIRE(sut.size() == 202);
+  REQUIRE(sut.sliceCount() == 4);
+  REQUIRE(sut.toString() == text + "yz");
+}
+
+TEST_CASE("BufferChain Split and trim share blocks.") {
+  ibex::BufferPool pool(80, 4);
+  ibex::BufferChain sut(pool);
+  sut.append(std::string("0123456789"));
+
+  ibex::BufferChain head = sut.split(4);
+  REQUIRE(head.toString() == "0123");
+  REQUIRE(sut.toString() == "456789");
+
+  // The shared block is not written to, appends take a new block
+  head.append("ab", 2);
+  REQUIRE(head.toString() == "0123ab");
+  REQUIRE(head.sliceCount() == 2);
+  REQUIRE(sut.toString() == "456789");
+
+  sut.trimFront(1);
+  sut.trimBack(2);
+  REQUIRE(sut.toString() == "567");
+  REQUIRE_THROWS_AS(sut.trimBack(4), std::out_of_range);
+
+  ibex::BufferChain joined(head);
+  joined.append(std::move(sut));
+  REQUIRE(joined.toString() == "0123ab567");
+  REQUIRE(sut.empty());
+  REQUIRE(head.toString() == "0123ab");
+}
+
+TEST_CASE("BufferChain Cursor reads across slices.") {
+  ibex::BufferPool pool(32, 4);
+  ibex::BufferChain sut(pool);
+  REQUIRE(pool.blockCapacity() == 16);
+
+  for (std::uint32_t i = 0; i < 10; ++i) sut.append(&i, sizeof(i));
+  sut.append(std::string("tail"));
+  REQUIRE(sut.sliceCount() > 2);
+
+  auto cursor = sut.cursor();
+  REQUIRE(cursor.peek<std::uint32_t>() == 0);
+  REQUIRE(cursor.read<std::uint32_t>() == 0);
+  cursor.skip(2);
+  cursor.skip(2);
+  for (std::uint32_t i = 2; i < 10; ++i) {
+    REQUIRE(cursor.read<std::uint32_t>() == i);
+  }
+  REQUIRE(cursor.contiguous().second > 0);
+  REQUIRE(cursor.readString(4) == "tail");
+  REQUIRE(cursor.remaining() == 0);
+  REQUIRE_THROWS_AS(cursor.read<char>(), std::out_of_range);
+}
+
+TEST_CASE("BufferChain Reads and writes through iovecs.") {
+  ibex::BufferPool pool(80, 4);
+  ibex::BufferChain sut(pool);
+  sut.append(std::string(150, 'a'));
+
+  int pipe[2];
+  REQUIRE(::pipe(pipe) == 0);
+  const auto vectors = sut.toIovec();
+  REQUIRE(vectors.size() == 3);
+  REQUIRE(::writev(pipe[1], vectors.data(), int(vectors.size())) == 150);
+
+  ibex::BufferChain received(pool);
+  while (received.size() < 150) {
+    auto [data, size] = received.prepare(1);
+    const ssize_t count = ::read(pipe[0], data, size);
+    REQUIRE(count > 0);
+    received.commit(std::size_t(count));
+  }
+  ::close(pipe[0]);
+  ::close(pipe[1]);
+  REQUIRE(received.toString() == sut.toString());
+}
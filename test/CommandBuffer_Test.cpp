@@ -0,0 +1,113 @@
+#include <ibex/CommandBuffer.h>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("CommandBuffer Callables are replayed in order.") {
+  ibex::CommandBuffer sut(256);
+  std::vector<int> calls;
+
+  for (int i = 0; i < 100; ++i) {
+    if (i % 2) {
+      sut.push([&calls, i] { calls.push_back(i); });
+    } else {
+      std::array<int, 12> payload{};
+      payload.back() = i;
+      sut.push([&calls, payload] { calls.push_back(payload.back()); });
+    }
+  }
+  sut.execute();
+
+  REQUIRE(sut.size() == 100);
+  REQUIRE(calls.size() == 100);
+  for (int i = 0; i < 100; ++i) REQUIRE(calls[i] == i);
+}
+
+TEST_CASE("CommandBuffer Records only take the space of their capture.") {
+  ibex::CommandBuffer sut;
+  int counter = 0;
+
+  sut.push([&counter] { ++counter; });
+
+  REQUIRE(sut.bytesUsed() == 24);
+}
+
+TEST_CASE("CommandBuffer Callables larger than a block get their own block.") {
+  ibex::CommandBuffer sut(64);
+  std::array<char, 1000> big{};
+  big[999] = 'x';
+  char seen = 0;
+
+  sut.push([&seen] { seen = 'a'; });
+  sut.push([&seen, big] { seen = big[999]; });
+  sut.execute();
+
+  REQUIRE(seen == 'x');
+}
+
+TEST_CASE("CommandBuffer Reset destroys captures and reuses memory.") {
+  ibex::CommandBuffer sut(128);
+  auto shared = std::make_shared<int>(0);
+
+  for (int i = 0; i < 10; ++i) sut.push([shared] { ++*shared; });
+  sut.execute();
+  REQUIRE(*shared == 10);
+  REQUIRE(shared.use_count() == 11);
+
+  sut.reset();
+  REQUIRE(sut.empty());
+  REQUIRE(shared.use_count() == 1);
+
+  sut.push([shared] { ++*shared; });
+  sut.execute();
+  REQUIRE(*shared == 11);
+}
+
+TEST_CASE("CommandBuffer Over-aligned captures are aligned.") {
+  struct alignas(16) Aligned {
+    char value;
+  };
+  ibex::CommandBuffer sut(256);
+  std::vector<std::uintptr_t> addresses;
+
+  for (int i = 0; i < 20; ++i) {
+    // A 24 byte record, so the next one starts 8 bytes off
+    sut.push([&addresses] { addresses.push_back(0); });
+    sut.push([&addresses, capture = Aligned{'x'}] {
+      addresses.push_back(reinterpret_cast<std::uintptr_t>(&capture));
+    });
+  }
+  sut.execute();
+
+  REQUIRE(addresses.size() == 40);
+  for (std::uintptr_t address : addresses) REQUIRE(address % 16 == 0);
+}
+
+TEST_CASE("CommandBuffer A throwing capture leaves the buffer unchanged.") {
+  struct Throwing {
+    Throwing() = default;
+    Throwing(const Throwing&) { throw std::runtime_error("copy"); }
+    void operator()() const {}
+  };
+  ibex::CommandBuffer sut;
+  int calls = 0;
+  auto shared = std::make_shared<int>(0);
+
+  sut.push([&calls, shared] { ++calls; });
+  const std::size_t used = sut.bytesUsed();
+  const Throwing throwing;
+  REQUIRE_THROWS_AS(sut.push(throwing), std::runtime_error);
+  REQUIRE(sut.size() == 1);
+  REQUIRE(sut.bytesUsed() == used);
+
+  sut.push([&calls] { ++calls; });
+  sut.execute();
+  REQUIRE(calls == 2);
+  sut.reset();
+  REQUIRE(shared.use_count() == 1);
+}
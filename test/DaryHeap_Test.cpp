@@ -0,0 +1,75 @@
+#include <ibex/DaryHeap.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+
+TEST_CASE("DaryHeap Popping returns elements in descending order.") {
+  ibex::DaryHeap<int> sut;
+  std::mt19937 rng(42);
+  std::vector<int> values(1000);
+  for (auto& value : values) value = int(rng() % 10000);
+
+  for (int value : values) sut.push(value);
+  std::sort(values.rbegin(), values.rend());
+
+  std::vector<int> popped;
+  while (!sut.empty()) {
+    popped.push_back(sut.top());
+    sut.pop();
+  }
+  REQUIRE(popped == values);
+}
+
+TEST_CASE("DaryHeap Updating keys through handles reorders the heap.") {
+  ibex::DaryHeap<int, 2, std::greater<int>> sut;
+  const auto a = sut.push(10);
+  const auto b = sut.push(20);
+  const auto c = sut.push(30);
+  REQUIRE(sut.top() == 10);
+
+  sut.increaseKey(c, 5);
+  REQUIRE(sut.topHandle() == c);
+
+  sut.decreaseKey(c, 40);
+  sut.update(b, 1);
+  REQUIRE(sut.topHandle() == b);
+  REQUIRE(sut.get(a) == 10);
+}
+
+TEST_CASE("DaryHeap Erasing an element invalidates only its handle.") {
+  ibex::DaryHeap<std::string, 8> sut;
+  const auto a = sut.push("a");
+  const auto b = sut.push("b");
+  const auto c = sut.push("c");
+
+  sut.erase(c);
+
+  REQUIRE_FALSE(sut.contains(c));
+  REQUIRE(sut.contains(a));
+  REQUIRE(sut.top() == "b");
+  REQUIRE(sut.topHandle() == b);
+  REQUIRE_THROWS_AS(sut.get(c), std::out_of_range);
+}
+
+TEST_CASE("DaryHeap Bulk heapify returns handles in input order.") {
+  ibex::DaryHeap<std::unique_ptr<int>, 4,
+                 std::function<bool(const std::unique_ptr<int>&,
+                                    const std::unique_ptr<int>&)>>
+      sut([](const auto& l, const auto& r) { return *l < *r; });
+  std::vector<int> values{5, 3, 9, 1, 7, 8, 2};
+  std::vector<std::unique_ptr<int>> input;
+  for (int value : values) input.push_back(std::make_unique<int>(value));
+
+  const auto handles = sut.assign(std::make_move_iterator(input.begin()),
+                                  std::make_move_iterator(input.end()));
+
+  REQUIRE(*sut.top() == 9);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    REQUIRE(*sut.get(handles[i]) == values[i]);
+  }
+}
@@ -0,0 +1,50 @@
+#include <ibex/DispatchTable.h>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace {
+  constexpr std::string_view kRoutes[] = {
+      "/",          "/index",   "/login",   "/logout", "/users",
+      "/users/new", "/orders",  "/metrics", "/health", "/status",
+      "/config",    "/reload",  "/debug",   "/trace",  "/api/v1",
+      "/api/v2",    "/static",  "/upload",  "/search", ""};
+
+  constexpr ibex::PerfectHash kRouteHash(kRoutes);
+}
+
+TEST_CASE("PerfectHash Every key is found at its position.") {
+  static_assert(kRouteHash.find("/metrics") == 7);
+
+  for (std::size_t i = 0; i < std::size(kRoutes); ++i) {
+    REQUIRE(kRouteHash.find(kRoutes[i]) == i);
+  }
+}
+
+TEST_CASE("PerfectHash Unknown keys are not found.") {
+  const std::size_t unknown = kRouteHash.size();
+
+  REQUIRE(kRouteHash.find("/unknown") == unknown);
+  REQUIRE(kRouteHash.find("/users/") == unknown);
+  REQUIRE(kRouteHash.find(std::string_view{}) == 19);
+}
+
+TEST_CASE("DispatchTable Invokes the handler registered for a key.") {
+  ibex::DispatchTable<std::string(int), 64, std::size(kRoutes)> sut(
+      kRouteHash);
+  const std::string prefix = "user ";
+
+  REQUIRE(sut.set("/users", [prefix](int id) {
+    return prefix + std::to_string(id);
+  }));
+  REQUIRE(sut.set("/health", [](int) { return std::string("ok"); }));
+  REQUIRE_FALSE(sut.set("/unknown", [](int) { return std::string(); }));
+
+  REQUIRE(sut("/users", 7) == "user 7");
+  REQUIRE(sut("/health", 0) == "ok");
+  REQUIRE(sut.find("/unknown") == nullptr);
+  REQUIRE_FALSE(*sut.find("/orders"));
+  REQUIRE_THROWS_AS(sut("/unknown", 0), std::out_of_range);
+  REQUIRE_THROWS_AS(sut("/orders", 0), std::bad_function_call);
+}
@@ -0,0 +1,88 @@
+#include <ibex/EventLoop.h>
+
+#include <catch2/catch.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <thread>
+
+namespace {
+  struct Pipe {
+    int read;
+    int write;
+
+    Pipe() {
+      int fds[2];
+      REQUIRE(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+      read = fds[0];
+      write = fds[1];
+    }
+
+    ~Pipe() {
+      ::close(read);
+      ::close(write);
+    }
+  };
+}
+
+TEST_CASE("EventLoop Handlers run when descriptors are ready.") {
+  ibex::EventLoop loop;
+  Pipe pipe;
+  std::string received;
+  loop.add(pipe.read, EPOLLIN | EPOLLET, [&](std::uint32_t events) {
+    REQUIRE((events & EPOLLIN) != 0);
+    char buffer[4];
+    ssize_t count;
+    while ((count = ::read(pipe.read, buffer, sizeof(buffer))) > 0) {
+      received.append(buffer, std::size_t(count));
+    }
+  });
+  REQUIRE(loop.size() == 1);
+  REQUIRE(loop.runOnce(0) == 0);
+
+  REQUIRE(::write(pipe.write, "hello world", 11) == 11);
+  REQUIRE(loop.runOnce(1000) == 1);
+  REQUIRE(received == "hello world");
+  // Edge-triggered: drained, so no new event
+  REQUIRE(loop.runOnce(0) == 0);
+
+  REQUIRE_THROWS_AS(loop.add(pipe.read, EPOLLIN, [](std::uint32_t) {}),
+                    std::system_error);
+}
+
+TEST_CASE("EventLoop Handlers can remove themselves.") {
+  ibex::EventLoop loop;
+  Pipe first;
+  Pipe second;
+  int calls = 0;
+  auto once = [&](int fd) {
+    return [&, fd](std::uint32_t) {
+      ++calls;
+      loop.remove(fd);
+    };
+  };
+  loop.add(first.read, EPOLLIN, once(first.read));
+  loop.add(second.read, EPOLLIN, once(second.read));
+  REQUIRE(::write(first.write, "x", 1) == 1);
+  REQUIRE(::write(second.write, "x", 1) == 1);
+
+  REQUIRE(loop.runOnce(1000) == 2);
+  REQUIRE(calls == 2);
+  REQUIRE(loop.size() == 0);
+  REQUIRE(loop.runOnce(0) == 0);
+}
+
+TEST_CASE("EventLoop Stop wakes up the loop from another thread.") {
+  ibex::EventLoop loop;
+  std::thread stopper([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    loop.stop();
+  });
+  loop.run();
+  stopper.join();
+
+  // A stop before run returns at once
+  loop.stop();
+  loop.run();
+}
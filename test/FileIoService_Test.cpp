@@ -0,0 +1,153 @@
+#include <ibex/FileIoService.h>
+
+#include <catch2/catch.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+  // A temporary file, removed on destruction
+  struct TempFile {
+    std::string path;
+    int file;
+
+    explicit TempFile(const char* name)
+        : path((std::filesystem::temp_directory_path() / name).string()),
+          file(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)) {}
+
+    ~TempFile() {
+      ::close(file);
+      std::filesystem::remove(path);
+    }
+  };
+
+  // Every backend that can be created here; io_uring may be forbidden
+  std::vector<ibex::FileIoOptions> backends() {
+    std::vector<ibex::FileIoOptions> result;
+    ibex::FileIoOptions options;
+    options.queueDepth = 8;
+    options.bufferCount = 4;
+    options.bufferSize = 4096;
+    options.backend = ibex::IoBackend::ThreadPool;
+    result.push_back(options);
+    try {
+      options.backend = ibex::IoBackend::IoUring;
+      ibex::FileIoService<> probe(options);
+      result.push_back(options);
+    } catch (const std::system_error&) {
+      WARN("io_uring is not available, testing the thread pool only");
+    }
+    return result;
+  }
+}
+
+TEST_CASE("FileIoService Writes and reads complete in callbacks.") {
+  for (const auto& options : backends()) {
+    TempFile temp("ibex_file_io_test");
+    ibex::FileIoService<> io(options);
+    REQUIRE(io.backend() == options.backend);
+
+    // More requests than the queue depth
+    std::vector<std::string> blocks;
+    for (int i = 0; i < 100; ++i) {
+      blocks.push_back(std::string(100, char('a' + i % 26)));
+    }
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+      io.write(temp.file, blocks[i].data(), 100, i * 100,
+               [&](ibex::IoResult result) { written += result.bytes(); });
+    }
+    REQUIRE(io.pending() == 100);
+    io.drain();
+    REQUIRE(written == 10000);
+    REQUIRE(io.pending() == 0);
+
+    bool synced = false;
+    io.fsync(temp.file, [&](ibex::IoResult result) { synced = result.ok(); });
+    REQUIRE(io.wait() == 1);
+    REQUIRE(synced);
+
+    std::vector<char> data(10000);
+    std::size_t reads = 0;
+    for (std::size_t i = 0; i < 100; ++i) {
+      io.read(temp.file, data.data() + i * 100, 100, i * 100,
+              [&](ibex::IoResult result) {
+                REQUIRE(result.bytes() == 100);
+                ++reads;
+              });
+    }
+    io.drain();
+    REQUIRE(reads == 100);
+    REQUIRE(std::string(data.data() + 2600, 100) == blocks[26]);
+    REQUIRE(std::string(data.data() + 9900, 100) == blocks[99]);
+
+    // Reading past the end is short
+    io.read(temp.file, data.data(), 100, 9950, [&](ibex::IoResult result) {
+      REQUIRE(result.bytes() == 50);
+    });
+    io.drain();
+    REQUIRE(io.poll() == 0);
+  }
+}
+
+TEST_CASE("FileIoService Errors are reported as error codes.") {
+  for (const auto& options : backends()) {
+    ibex::FileIoService<> io(options);
+    char buffer[16];
+    ibex::IoResult outcome{0};
+    io.read(-1, buffer, sizeof(buffer), 0,
+            [&](ibex::IoResult result) { outcome = result; });
+    io.drain();
+    REQUIRE_FALSE(outcome.ok());
+    REQUIRE(outcome.error() == std::errc::bad_file_descriptor);
+    REQUIRE(outcome.bytes() == 0);
+  }
+}
+
+TEST_CASE("FileIoService Registered buffers and chained requests.") {
+  for (const auto& options : backends()) {
+    TempFile temp("ibex_file_io_fixed_test");
+    ibex::FileIoService<> io(options);
+    REQUIRE(io.bufferCount() == 4);
+    REQUIRE(io.bufferSize() >= 4096);
+    REQUIRE_THROWS_AS(io.buffer(4), std::out_of_range);
+    REQUIRE_THROWS_AS(
+        io.readFixed(temp.file, 0, io.bufferSize() + 1, 0, [](auto) {}),
+        std::out_of_range);
+
+    std::memset(io.buffer(1), 'x', 4096);
+    // The callback of the write starts the read of the same range
+    bool done = false;
+    io.writeFixed(temp.file, 1, 4096, 0, [&](ibex::IoResult written) {
+      REQUIRE(written.bytes() == 4096);
+      io.readFixed(temp.file, 2, 4096, 0, [&](ibex::IoResult read) {
+        REQUIRE(read.bytes() == 4096);
+        done = true;
+      });
+    });
+    io.drain();
+    REQUIRE(done);
+    REQUIRE(char(io.buffer(2)[4095]) == 'x');
+  }
+}
+
+TEST_CASE("FileIoService Destruction waits for requests in flight.") {
+  for (const auto& options : backends()) {
+    TempFile temp("ibex_file_io_destroy_test");
+    std::vector<char> data(4096, 'y');
+    bool called = false;
+    {
+      ibex::FileIoService<> io(options);
+      io.write(temp.file, data.data(), data.size(), 0,
+               [&](ibex::IoResult) { called = true; });
+      io.submit();
+    }
+    REQUIRE_FALSE(called);
+    REQUIRE(::lseek(temp.file, 0, SEEK_END) == 4096);
+  }
+}
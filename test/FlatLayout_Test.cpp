@@ -0,0 +1,104 @@
+#include <ibex/FlatLayout.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <memory>
+
+namespace {
+  enum class Side : std::uint8_t { Buy, Sell };
+
+  struct Fill {
+    ibex::LittleEndian<std::int64_t> quantity;
+    ibex::LittleEndian<double> price;
+  };
+
+  struct Order {
+    ibex::LittleEndian<std::uint64_t> id;
+    ibex::LittleEndian<Side> side;
+    ibex::Offset<ibex::FlatString> symbol;
+    ibex::Offset<ibex::FlatVector<Fill>> fills;
+    ibex::Offset<Order> parent;
+  };
+
+  // Copy into fresh aligned memory, like a received message
+  std::unique_ptr<std::max_align_t[]> receive(
+      std::pair<const std::byte*, std::size_t> buffer) {
+    std::unique_ptr<std::max_align_t[]> copy(
+        new std::max_align_t[buffer.second / sizeof(std::max_align_t) + 1]);
+    std::memcpy(copy.get(), buffer.first, buffer.second);
+    return copy;
+  }
+}
+
+TEST_CASE("FlatLayout Objects are read in place.") {
+  ibex::FlatBuilder builder;
+  Order parent{};
+  parent.id = 1;
+  const auto parentOffset = builder.create(parent);
+
+  Order order{};
+  order.id = 42;
+  order.side = Side::Sell;
+  order.symbol = builder.createString("IBEX");
+  order.fills = builder.createVector(std::vector<Fill>{{10, 1.5}, {20, 2.5}});
+  order.parent = parentOffset;
+  const auto buffer = builder.finish(order);
+  REQUIRE(buffer.second % 16 == 0);
+
+  const auto received = receive(buffer);
+  const ibex::FlatView view(received.get(), buffer.second);
+  const Order& root = view.root<Order>();
+  REQUIRE(root.id == 42);
+  REQUIRE(root.side == Side::Sell);
+  REQUIRE(view.string(root.symbol) == "IBEX");
+  REQUIRE(view.string(root.symbol).data() >
+          reinterpret_cast<const char*>(received.get()));
+
+  const auto fills = view.vector(root.fills);
+  REQUIRE(fills.size() == 2);
+  REQUIRE(fills[1].quantity == 20);
+  REQUIRE(fills.at(0).price == 1.5);
+  REQUIRE_THROWS_AS(fills.at(2), std::out_of_range);
+
+  REQUIRE(view.resolve(root.parent)->id == 1);
+  REQUIRE(view.resolve(view.resolve(root.parent)->parent) == nullptr);
+  REQUIRE(view.vector(view.resolve(root.parent)->fills).empty());
+}
+
+TEST_CASE("FlatLayout Corrupt buffers are rejected.") {
+  ibex::FlatBuilder builder;
+  Order order{};
+  order.symbol = builder.createString("IBEX");
+  const auto buffer = builder.finish(order);
+  const auto received = receive(buffer);
+  auto* bytes = reinterpret_cast<std::byte*>(received.get());
+
+  REQUIRE_THROWS_AS(ibex::FlatView(bytes, 8), std::invalid_argument);
+  REQUIRE_THROWS_AS(ibex::FlatView(bytes, buffer.second - 16),
+                    std::invalid_argument);
+  REQUIRE_THROWS_AS(ibex::FlatView(bytes + 1, buffer.second),
+                    std::invalid_argument);
+
+  const ibex::FlatView view(bytes, buffer.second);
+  auto& root = const_cast<Order&>(view.root<Order>());
+  root.symbol.position = std::uint32_t(buffer.second);
+  REQUIRE_THROWS_AS(view.string(root.symbol), std::out_of_range);
+  root.symbol.position = 4;
+  REQUIRE_THROWS_AS(view.string(root.symbol), std::out_of_range);
+  root.fills.position = std::uint32_t(buffer.second - 4);
+  REQUIRE_THROWS_AS(view.vector(root.fills), std::out_of_range);
+
+  std::memset(bytes + 8, 0, 4);  // Null root offset
+  REQUIRE_THROWS_AS(view.root<Order>(), std::out_of_range);
+}
+
+TEST_CASE("FlatLayout LittleEndian stores the little-endian byte order.") {
+  const ibex::LittleEndian<std::uint32_t> value(0x01020304);
+  unsigned char bytes[4];
+  std::memcpy(bytes, &value, 4);
+  REQUIRE(bytes[0] == 0x04);
+  REQUIRE(bytes[3] == 0x01);
+  REQUIRE(value.get() == 0x01020304);
+  static_assert(alignof(ibex::LittleEndian<double>) == alignof(double));
+}
@@ -0,0 +1,44 @@
+#include <ibex/FunctionRef.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <type_traits>
+
+namespace {
+  int twice(int value) { return 2 * value; }
+
+  int apply(ibex::FunctionRef<int(int)> f, int value) { return f(value); }
+}
+
+TEST_CASE("FunctionRef Calls lambdas, functors and function pointers.") {
+  int calls = 0;
+  auto counting = [&calls](int value) {
+    ++calls;
+    return value + 1;
+  };
+
+  REQUIRE(apply(counting, 1) == 2);
+  REQUIRE(apply([](int value) { return value * value; }, 3) == 9);
+  REQUIRE(apply(twice, 4) == 8);
+  REQUIRE(apply(&twice, 5) == 10);
+  REQUIRE(calls == 1);
+}
+
+TEST_CASE("FunctionRef Is two pointers and refers to the target.") {
+  static_assert(std::is_trivially_copyable_v<ibex::FunctionRef<void()>>);
+  static_assert(sizeof(ibex::FunctionRef<void()>) == 2 * sizeof(void*));
+
+  int state = 0;
+  auto increment = [&state] { return ++state; };
+  ibex::FunctionRef<int()> sut = increment;
+  ibex::FunctionRef<int()> copy = sut;
+  sut();
+  REQUIRE(copy() == 2);
+
+  auto owner = std::make_unique<int>(7);
+  ibex::FunctionRef<void(std::unique_ptr<int>)> sink =
+      [](std::unique_ptr<int> value) { REQUIRE(*value == 7); };
+  sink(std::move(owner));
+  REQUIRE(owner == nullptr);
+}
@@ -1,4 +1,11 @@
 #include <ibex/Function.h>
+#include <ibex/Graveyard.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -89,3 +96,115 @@ TEST_CASE("Unique_ptr in function calls destructor only once.") {
 
   REQUIRE(dtor_counter::count == 1);
 }
+
+TEST_CASE("make_function deduces the smallest fitting size class.") {
+  std::array<char, 40> buffer{};
+  buffer[0] = 3;
+  auto f = ibex::make_function<int(int)>(
+      [buffer](int i) { return buffer[0] * i; });
+
+  static_assert(ibex::function_target_size_v<decltype(buffer)> == 48);
+  static_assert(std::is_same_v<decltype(f), ibex::Function<int(int), 48>>);
+  REQUIRE(f(2) == 6);
+}
+
+TEST_CASE("fits_in_v compares the target size with Size.") {
+  auto lambda = [ptr = std::unique_ptr<int>()] {};
+
+  static_assert(ibex::fits_in_v<decltype(lambda), 16>);
+  static_assert(!ibex::fits_in_v<std::array<char, 17>, 16>);
+  static_assert(ibex::function_size_v<std::array<char, 60>> == 80);
+  static_assert(ibex::function_size_v<std::array<char, 200>> == 224);
+}
+
+TEST_CASE("DeferredFunction destroys its target only when drained.") {
+  auto shared = std::make_shared<int>(0);
+
+  {
+    ibex::DeferredFunction<void(), 32> f([shared] { ++*shared; });
+    f();
+    f = ibex::DeferredFunction<void(), 32>([shared] { ++*shared; });
+    f();
+    REQUIRE(shared.use_count() == 3);
+  }
+  REQUIRE(shared.use_count() == 3);
+  REQUIRE(*shared == 2);
+
+  REQUIRE(ibex::Graveyard::local().drain() == 2);
+  REQUIRE(shared.use_count() == 1);
+}
+
+namespace {
+  struct copy_counter {
+    inline static int copies{0};
+    inline static int moves{0};
+
+    copy_counter() = default;
+    copy_counter(const copy_counter&) { ++copies; }
+    copy_counter(copy_counter&&) { ++moves; }
+  };
+}
+
+TEST_CASE("By-value arguments are copied or moved into the target once.") {
+  ibex::Function<void(copy_counter), 32> f([](copy_counter) {});
+  copy_counter arg;
+
+  copy_counter::copies = copy_counter::moves = 0;
+  f(arg);
+  REQUIRE(copy_counter::copies == 1);
+  REQUIRE(copy_counter::moves == 0);
+
+  copy_counter::copies = copy_counter::moves = 0;
+  f(std::move(arg));
+  REQUIRE(copy_counter::copies == 0);
+  REQUIRE(copy_counter::moves == 1);
+}
+
+TEST_CASE("Reference arguments are not copied.") {
+  ibex::Function<void(const copy_counter&, copy_counter&), 32> f(
+      [](const copy_counter&, copy_counter&) {});
+  copy_counter arg;
+
+  copy_counter::copies = copy_counter::moves = 0;
+  f(arg, arg);
+  REQUIRE(copy_counter::copies == 0);
+  REQUIRE(copy_counter::moves == 0);
+}
+
+TEST_CASE("Arguments are converted to the parameter types.") {
+  ibex::Function<double(double, const std::string&), 32> f(
+      [](double d, const std::string& s) { return d * double(s.size()); });
+
+  REQUIRE(f(2, "ibex") == 8.0);
+}
+
+TEST_CASE("Targets taking a const reference get one copy of lvalues.") {
+  ibex::Function<void(copy_counter), 32> f([](const copy_counter&) {});
+  const copy_counter arg;
+
+  copy_counter::copies = copy_counter::moves = 0;
+  f(arg);
+  REQUIRE(copy_counter::copies == 1);
+  REQUIRE(copy_counter::moves == 0);
+}
+
+TEST_CASE("Move-only arguments are moved into the target.") {
+  ibex::Function<int(std::unique_ptr<int>), 32> f(
+      [](std::unique_ptr<int> p) { return *p; });
+
+  REQUIRE(f(std::make_unique<int>(7)) == 7);
+}
+
+TEST_CASE("Braced initializer lists are accepted as arguments.") {
+  ibex::Function<int(std::vector<int>), 64> f(
+      [](std::vector<int> v) { return int(v.size()); });
+  ibex::Function<int(const std::pair<int, int>&, int), 32> g(
+      [](const std::pair<int, int>& p, int i) { return p.first + p.second + i; });
+  ibex::Function<std::size_t(std::string), 32> h(
+      [](std::string s) { return s.size(); });
+
+  REQUIRE(f({1, 2, 3}) == 3);
+  REQUIRE(f({}) == 0);
+  REQUIRE(g({1, 2}, 3) == 6);
+  REQUIRE(h({"abc"}) == 3);
+}
@@ -0,0 +1,146 @@
+#include <ibex/Graveyard.h>
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+TEST_CASE("Graveyard Buried objects live until the graveyard is drained.") {
+  auto shared = std::make_shared<int>(0);
+  auto& sut = ibex::Graveyard::local();
+
+  sut.bury(std::shared_ptr<int>(shared));
+  sut.bury(std::move(shared));
+  REQUIRE_FALSE(shared);
+
+  std::weak_ptr<int> weak;
+  {
+    auto another = std::make_shared<int>(1);
+    weak = another;
+    sut.bury(std::move(another));
+  }
+  REQUIRE_FALSE(weak.expired());
+
+  REQUIRE(sut.drain() == 3);
+  REQUIRE(weak.expired());
+}
+
+TEST_CASE("Graveyard Objects buried by other threads are drained.") {
+  auto shared = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = shared;
+  std::mutex mutex;
+  std::condition_variable cv;
+  int step = 0;
+  const auto advance = [&](int from) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return step == from; });
+    ++step;
+    cv.notify_all();
+  };
+
+  std::thread worker([&] {
+    ibex::Graveyard::local().bury(std::move(shared));
+    advance(0);
+    advance(3);
+    // Hands over everything buried so far, as a drain has been requested
+    ibex::Graveyard::local().bury(0);
+    advance(4);
+    advance(7);
+  });
+
+  advance(1);
+  ibex::Graveyard::drainAll();
+  const bool aliveAfterRequest = !weak.expired();
+  advance(2);
+  advance(5);
+  ibex::Graveyard::drainAll();
+  const bool expiredAfterHandOver = weak.expired();
+  advance(6);
+  worker.join();
+
+  REQUIRE(aliveAfterRequest);
+  REQUIRE(expiredAfterHandOver);
+}
+
+TEST_CASE("Graveyard Objects are destroyed when the owning thread exits.") {
+  auto shared = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = shared;
+
+  std::thread([&] { ibex::Graveyard::local().bury(std::move(shared)); })
+      .join();
+
+  REQUIRE(weak.expired());
+}
+
+TEST_CASE("Graveyard Objects buried while draining are drained too.") {
+  auto& sut = ibex::Graveyard::local();
+  sut.drain();
+  auto shared = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = shared;
+
+  {
+    ibex::DeferredFunction<void(), 32> inner([shared = std::move(shared)] {});
+    // Destroying the buried outer target buries the inner one
+    ibex::DeferredFunction<void(), 64> outer([inner = std::move(inner)] {});
+  }
+
+  REQUIRE(sut.drain() == 2);
+  REQUIRE(weak.expired());
+  REQUIRE(sut.drain() == 0);
+}
+
+TEST_CASE("Graveyard Draining may create the graveyard of the thread.") {
+  auto shared = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = shared;
+  std::mutex mutex;
+  std::condition_variable cv;
+  int step = 0;
+  const auto advance = [&](int from) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return step == from; });
+    ++step;
+    cv.notify_all();
+  };
+
+  std::thread worker([&] {
+    ibex::Graveyard::local().bury(ibex::DeferredFunction<void(), 32>(
+        [shared = std::move(shared)] {}));
+    advance(0);
+    advance(3);
+    ibex::Graveyard::local().bury(0);  // Hands over the DeferredFunction
+    advance(4);
+    advance(7);
+  });
+
+  advance(1);
+  ibex::Graveyard::drainAll();
+  advance(2);
+  advance(5);
+  // Its target is buried in the graveyard of a new thread, from drainAll()
+  std::thread([] { ibex::Graveyard::drainAll(); }).join();
+  const bool expiredAfterDrain = weak.expired();
+  advance(6);
+  worker.join();
+
+  REQUIRE(expiredAfterDrain);
+}
+
+TEST_CASE("GraveyardDrainer drains in the background.") {
+  auto shared = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = shared;
+
+  {
+    ibex::GraveyardDrainer drainer(std::chrono::milliseconds(1));
+    ibex::Graveyard::local().bury(std::move(shared));
+    // Keep burying, so the buried objects are handed over to the drainer
+    for (int i = 0; i < 10000 && !weak.expired(); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      ibex::Graveyard::local().bury(i);
+    }
+  }
+
+  REQUIRE(weak.expired());
+}
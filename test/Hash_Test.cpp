@@ -0,0 +1,130 @@
+#include <ibex/Hash.h>
+
+#include <catch2/catch.hpp>
+
+#include <bitset>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+  struct Point {
+    int x;
+    int y;
+  };
+
+  std::uint64_t hashValue(const Point& p) { return ibex::hashValues(p.x, p.y); }
+
+  // Average number of output bits flipped by flipping one input bit
+  template <typename HashFunction>
+  double avalanche(std::size_t size, HashFunction hash) {
+    std::mt19937_64 rng(7);
+    std::vector<unsigned char> key(size);
+    double flipped = 0;
+    std::size_t trials = 0;
+    for (int round = 0; round < 64; ++round) {
+      for (auto& byte : key) byte = static_cast<unsigned char>(rng());
+      const std::uint64_t original = hash(key);
+      for (std::size_t bit = 0; bit < size * 8; ++bit) {
+        key[bit / 8] ^= 1 << (bit % 8);
+        flipped += std::bitset<64>(original ^ hash(key)).count();
+        key[bit / 8] ^= 1 << (bit % 8);
+        ++trials;
+      }
+    }
+    return flipped / trials;
+  }
+}
+
+TEST_CASE("Hash Equal strings hash equally.") {
+  const std::string owned = "content-type";
+  const std::string_view view = "content-type";
+
+  REQUIRE(ibex::Hash<std::string>{}(owned) ==
+          ibex::Hash<std::string_view>{}(view));
+  REQUIRE(ibex::hashString(view) ==
+          ibex::hashBytes(owned.data(), owned.size()));
+  REQUIRE(ibex::hashString(view) != ibex::hashString("content-typE"));
+  REQUIRE(ibex::hashString(view) != ibex::hashString(view, 1));
+}
+
+TEST_CASE("Hash Every prefix hashes differently.") {
+  std::string text(200, 'a');
+  std::set<std::uint64_t> hashes;
+  for (std::size_t size = 0; size <= text.size(); ++size) {
+    hashes.insert(ibex::hashString(std::string_view(text.data(), size)));
+  }
+
+  REQUIRE(hashes.size() == text.size() + 1);
+}
+
+TEST_CASE("Hash Flipping an input bit flips half of the output bits.") {
+  for (const std::size_t size : {1, 3, 8, 13, 16, 24, 48, 64, 100}) {
+    CAPTURE(size);
+    const double bits = avalanche(size, [](const auto& key) {
+      return ibex::hashBytes(key.data(), key.size());
+    });
+    REQUIRE(bits > 31.0);
+    REQUIRE(bits < 33.0);
+  }
+
+  const double bits = avalanche(8, [](const auto& key) {
+    std::uint64_t value;
+    std::memcpy(&value, key.data(), sizeof(value));
+    return ibex::hashInteger(value);
+  });
+  REQUIRE(bits > 31.0);
+  REQUIRE(bits < 33.0);
+}
+
+TEST_CASE("Hash Strided integers spread over a power-of-two table.") {
+  // std::hash is the identity here and would fill one bucket in 64
+  constexpr std::size_t kBuckets = 1024;
+  std::vector<std::size_t> counts(kBuckets);
+  for (std::uint64_t i = 0; i < 64 * kBuckets; ++i) {
+    ++counts[ibex::Hash<std::uint64_t>{}(i * 64) & (kBuckets - 1)];
+  }
+
+  for (const std::size_t count : counts) {
+    REQUIRE(count > 24);
+    REQUIRE(count < 112);
+  }
+}
+
+TEST_CASE("Hash Integers never collide.") {
+  std::set<std::size_t> hashes;
+  for (int i = -1000; i < 1000; ++i) hashes.insert(ibex::Hash<int>{}(i));
+
+  REQUIRE(hashes.size() == 2000);
+}
+
+TEST_CASE("Hash Combining depends on the order.") {
+  REQUIRE(ibex::hashValues(1, 2) != ibex::hashValues(2, 1));
+  REQUIRE(ibex::hashValues(1, 2) == ibex::hashValues(1, 2));
+  REQUIRE(ibex::Hash<std::pair<int, int>>{}({1, 2}) == ibex::hashValues(1, 2));
+  REQUIRE(ibex::Hash<std::tuple<int, std::string>>{}({1, "one"}) ==
+          ibex::hashValues(1, std::string("one")));
+}
+
+TEST_CASE("Hash Structs are hashed by hashValue.") {
+  const ibex::Hash<Point> hash;
+
+  REQUIRE(hash(Point{1, 2}) == ibex::hashValues(1, 2));
+  REQUIRE(hash(Point{1, 2}) != hash(Point{2, 1}));
+}
+
+TEST_CASE("Hash Zeros of either sign hash equally.") {
+  REQUIRE(ibex::Hash<double>{}(0.0) == ibex::Hash<double>{}(-0.0));
+  REQUIRE(ibex::Hash<double>{}(1.0) != ibex::Hash<double>{}(-1.0));
+  REQUIRE(ibex::Hash<long double>{}(2.5L) == ibex::Hash<long double>{}(2.5L));
+}
+
+TEST_CASE("Hash Other types fall back to std::hash.") {
+  const std::bitset<8> bits(42);
+
+  REQUIRE(ibex::Hash<std::bitset<8>>{}(bits) ==
+          ibex::hashInteger(std::hash<std::bitset<8>>{}(bits)));
+}
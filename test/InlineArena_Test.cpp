@@ -0,0 +1,100 @@
+#include <ibex/AccountingResource.h>
+#include <ibex/InlineArena.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+  bool isInside(const void* pointer, const void* object, std::size_t size) {
+    const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+    const auto begin = reinterpret_cast<std::uintptr_t>(object);
+    return begin <= address && address < begin + size;
+  }
+}
+
+TEST_CASE("InlineArena Small allocations stay inside the object.") {
+  ibex::MemoryTag tag("parent");
+  ibex::AccountingResource parent(tag);
+  ibex::InlineArena<256> sut(&parent);
+
+  void* a = sut.allocate(10, 1);
+  void* b = sut.allocate(32, 32);
+  REQUIRE(isInside(a, &sut, sizeof(sut)));
+  REQUIRE(isInside(b, &sut, sizeof(sut)));
+  REQUIRE(reinterpret_cast<std::uintptr_t>(b) % 32 == 0);
+  REQUIRE_FALSE(sut.spilled());
+  REQUIRE(tag.stats().allocations == 0);
+}
+
+TEST_CASE("InlineArena Spills to the parent when exhausted.") {
+  ibex::MemoryTag tag("parent");
+  ibex::AccountingResource parent(tag);
+  {
+    ibex::InlineArena<64> sut(&parent);
+    void* a = sut.allocate(48);
+    void* b = sut.allocate(48);
+    std::memset(b, 0, 48);
+    REQUIRE(isInside(a, &sut, sizeof(sut)));
+    REQUIRE_FALSE(isInside(b, &sut, sizeof(sut)));
+    REQUIRE(sut.spilled());
+    REQUIRE(tag.stats().liveBytes > 0);
+
+    sut.reset();
+    REQUIRE_FALSE(sut.spilled());
+    REQUIRE(tag.stats().liveBytes == 0);
+    REQUIRE(sut.allocate(48) == a);
+    sut.allocate(1000);
+  }
+  REQUIRE(tag.stats().liveBytes == 0);
+}
+
+TEST_CASE("InlineArena The most recent allocation is reclaimed.") {
+  ibex::InlineArena<128> sut;
+
+  void* a = sut.allocate(16);
+  void* b = sut.allocate(16);
+  sut.deallocate(a, 16);
+  sut.deallocate(b, 16);
+  REQUIRE(sut.allocate(16) == b);
+  REQUIRE(sut.used() == 32);
+}
+
+TEST_CASE("InlineArena Works with pmr containers and reports high water.") {
+  ibex::InlineArena<1024> sut;
+  {
+    std::pmr::vector<int> values(sut.allocator<int>());
+    values.reserve(100);
+    for (int i = 0; i < 100; ++i) values.push_back(i);
+    REQUIRE(isInside(values.data(), &sut, sizeof(sut)));
+    REQUIRE(values[99] == 99);
+  }
+  REQUIRE(sut.highWaterMark() >= 400);
+  REQUIRE(sut.highWaterMark() <= sut.capacity());
+  REQUIRE_FALSE(sut.spilled());
+
+  sut.reset();
+  REQUIRE(sut.used() == 0);
+  REQUIRE(sut.highWaterMark() >= 400);
+}
+
+TEST_CASE("InlineArena A growing pmr vector falls back to the parent.") {
+  ibex::MemoryTag tag("parent");
+  ibex::AccountingResource parent(tag);
+  ibex::InlineArena<1024> sut(&parent);
+  {
+    // Old buffers are not reclaimed, so growth needs more than 1024 bytes
+    // in total although the final 256 ints would fit
+    std::pmr::vector<int> values(sut.allocator<int>());
+    for (int i = 0; i < 256; ++i) values.push_back(i);
+    REQUIRE_FALSE(isInside(values.data(), &sut, sizeof(sut)));
+    REQUIRE(values[255] == 255);
+  }
+  REQUIRE(sut.spilled());
+  REQUIRE(tag.stats().allocations > 0);
+
+  sut.reset();
+  REQUIRE(tag.stats().liveBytes == 0);
+}
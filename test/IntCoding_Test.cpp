@@ -0,0 +1,139 @@
+#include <ibex/IntCoding.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("IntCoding Varints round trip.") {
+  const std::vector<std::uint64_t> values = {
+      0, 1, 127, 128, 300, 16383, 16384, UINT32_MAX, UINT64_MAX};
+  std::vector<std::uint8_t> bytes(10 * values.size());
+  const std::size_t size =
+      ibex::encodeVarints(values.data(), values.size(), bytes.data());
+  REQUIRE(size == 1 + 1 + 1 + 2 + 2 + 2 + 3 + 5 + 10);
+
+  const std::uint8_t* cursor = bytes.data();
+  for (const std::uint64_t value : values) {
+    REQUIRE(ibex::decodeVarint(cursor, bytes.data() + size) == value);
+  }
+  REQUIRE(cursor == bytes.data() + size);
+
+  std::uint8_t byte = 0;
+  REQUIRE(ibex::encodeVarint(300, bytes.data()) == 2);
+  REQUIRE(bytes[0] == 0xac);
+  REQUIRE(bytes[1] == 0x02);
+  REQUIRE(ibex::encodeVarint(5, &byte) == 1);
+  REQUIRE(byte == 5);
+
+  for (const std::int64_t value : {0L, -1L, 1L, -64L, INT64_MIN, INT64_MAX}) {
+    REQUIRE(ibex::zigzagDecode(ibex::zigzagEncode(value)) == value);
+  }
+  REQUIRE(ibex::zigzagEncode(-1) == 1);
+  REQUIRE(ibex::zigzagEncode(1) == 2);
+}
+
+TEST_CASE("IntCoding Bulk decode matches scalar decode.") {
+  std::mt19937_64 rng(7);
+  for (const unsigned maxBits : {7u, 14u, 21u, 32u, 64u}) {
+    std::vector<std::uint64_t> values(1000);
+    for (auto& value : values) {
+      value = maxBits == 64 ? rng() : rng() % (std::uint64_t(1) << maxBits);
+    }
+    std::vector<std::uint8_t> bytes(10 * values.size());
+    const std::size_t size =
+        ibex::encodeVarints(values.data(), values.size(), bytes.data());
+
+    std::vector<std::uint64_t> decoded(values.size());
+    const std::uint8_t* end = ibex::decodeVarints(
+        bytes.data(), bytes.data() + size, decoded.data(), decoded.size());
+    REQUIRE(end == bytes.data() + size);
+    REQUIRE(decoded == values);
+
+    if (maxBits <= 32) {
+      std::vector<std::uint32_t> narrow(values.size());
+      ibex::decodeVarints(bytes.data(), bytes.data() + size, narrow.data(),
+                          narrow.size());
+      REQUIRE(std::equal(narrow.begin(), narrow.end(), values.begin()));
+    }
+
+    // A prefix stops after the requested count
+    const std::uint8_t* middle = ibex::decodeVarints(
+        bytes.data(), bytes.data() + size, decoded.data(), 500);
+    REQUIRE(ibex::decodeVarint(middle, bytes.data() + size) == values[500]);
+  }
+}
+
+TEST_CASE("IntCoding Malformed varints throw.") {
+  std::vector<std::uint8_t> bytes(32, 0x80);
+  const std::uint8_t* cursor = bytes.data();
+  REQUIRE_THROWS_AS(ibex::decodeVarint(cursor, bytes.data() + 3),
+                    std::out_of_range);
+  cursor = bytes.data();
+  REQUIRE_THROWS_AS(ibex::decodeVarint(cursor, bytes.data() + bytes.size()),
+                    std::invalid_argument);
+
+  std::vector<std::uint64_t> values(16);
+  REQUIRE_THROWS_AS(ibex::decodeVarints(bytes.data(),
+                                        bytes.data() + bytes.size(),
+                                        values.data(), values.size()),
+                    std::invalid_argument);
+  bytes[11] = 1;  // 12 byte varint inside a 16 byte window
+  REQUIRE_THROWS_AS(ibex::decodeVarints(bytes.data(),
+                                        bytes.data() + bytes.size(),
+                                        values.data(), values.size()),
+                    std::invalid_argument);
+}
+
+TEST_CASE("IntCoding Blocks pack with every bit width.") {
+  std::mt19937 rng(3);
+  for (unsigned bits = 0; bits <= 32; ++bits) {
+    std::vector<std::uint32_t> values(ibex::kPackedBlockSize);
+    for (auto& value : values) {
+      value = bits == 32 ? rng() : rng() & ((std::uint32_t(1) << bits) - 1);
+    }
+    std::vector<std::uint32_t> packed(ibex::packedBlockWords(bits) + 1, 7);
+    ibex::packBlock(values.data(), bits, packed.data());
+    REQUIRE(packed.back() == 7);
+
+    std::vector<std::uint32_t> unpacked(ibex::kPackedBlockSize, 1);
+    ibex::unpackBlock(packed.data(), bits, unpacked.data());
+    REQUIRE(unpacked == values);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      REQUIRE(ibex::unpackValue(packed.data(), bits, i) == values[i]);
+    }
+  }
+  REQUIRE(ibex::bitWidth(0) == 0);
+  REQUIRE(ibex::bitWidth(1) == 1);
+  REQUIRE(ibex::bitWidth(255) == 8);
+  REQUIRE(ibex::bitWidth(UINT32_MAX) == 32);
+}
+
+TEST_CASE("IntCoding Delta packing round trips and compresses.") {
+  std::mt19937 rng(5);
+  std::vector<std::uint32_t> sorted(10000);
+  std::uint32_t id = 1000000;
+  for (auto& value : sorted) value = id += 1 + rng() % 8;
+
+  const auto words = ibex::encodeDeltaPacked(sorted);
+  REQUIRE(ibex::decodeDeltaPacked(words) == sorted);
+  REQUIRE(words.size() * 8 < sorted.size());  // Under 4 bits per value
+
+  std::vector<std::uint32_t> random(300);
+  for (auto& value : random) value = rng();
+  REQUIRE(ibex::decodeDeltaPacked(ibex::encodeDeltaPacked(random)) == random);
+
+  REQUIRE(ibex::decodeDeltaPacked(ibex::encodeDeltaPacked({})).empty());
+  const std::vector<std::uint32_t> one = {42};
+  REQUIRE(ibex::decodeDeltaPacked(ibex::encodeDeltaPacked(one)) == one);
+
+  auto truncated = words;
+  truncated.resize(truncated.size() - 1);
+  REQUIRE_THROWS_AS(ibex::decodeDeltaPacked(truncated), std::out_of_range);
+  REQUIRE_THROWS_AS(ibex::decodeDeltaPacked(nullptr, 0), std::out_of_range);
+
+  // A corrupt count is rejected before anything is allocated for it
+  const std::vector<std::uint32_t> bogus = {UINT32_MAX, 0, 0};
+  REQUIRE_THROWS_AS(ibex::decodeDeltaPacked(bogus), std::out_of_range);
+}
@@ -0,0 +1,54 @@
+#include <ibex/Interner.h>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <thread>
+
+TEST_CASE("Interner Equal strings get the same id.") {
+  ibex::Interner sut;
+  std::string header = "content-type";
+
+  const auto id = sut.intern(header);
+  header[0] = 'C';
+
+  REQUIRE(sut.intern("content-type") == id);
+  REQUIRE(sut.intern(header) != id);
+  REQUIRE(sut.view(id) == "content-type");
+  REQUIRE(sut.size() == 2);
+}
+
+TEST_CASE("Interner Views stay valid while the interner grows.") {
+  ibex::Interner sut;
+  const auto first = sut.view(sut.intern("first"));
+  const char* data = first.data();
+
+  for (int i = 0; i < 100000; ++i) sut.intern("label_" + std::to_string(i));
+
+  REQUIRE(sut.view(0).data() == data);
+  REQUIRE(sut.find("label_4711") == sut.intern("label_4711"));
+  REQUIRE(sut.view(*sut.find("label_99999")) == "label_99999");
+  REQUIRE_FALSE(sut.find("label_100000"));
+}
+
+TEST_CASE("Interner Concurrent interning assigns each string one id.") {
+  ibex::Interner sut;
+  constexpr int kStrings = 5000;
+  std::vector<std::vector<ibex::Interner::Id>> ids(4);
+
+  std::vector<std::thread> threads;
+  for (auto& out : ids) {
+    threads.emplace_back([&sut, &out] {
+      for (int i = 0; i < kStrings; ++i) {
+        out.push_back(sut.intern("metric." + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  REQUIRE(sut.size() == kStrings);
+  for (const auto& out : ids) REQUIRE(out == ids[0]);
+  for (int i = 0; i < kStrings; ++i) {
+    REQUIRE(sut.view(ids[0][i]) == "metric." + std::to_string(i));
+  }
+}
@@ -0,0 +1,63 @@
+#include <ibex/Lazy.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Lazy Value is constructed on first access only.") {
+  int calls = 0;
+  ibex::Lazy<std::vector<int>, 32> sut([&calls] {
+    ++calls;
+    return std::vector<int>{1, 2, 3};
+  });
+
+  REQUIRE_FALSE(sut.initialized());
+  REQUIRE(calls == 0);
+
+  REQUIRE(sut->size() == 3);
+  REQUIRE((*sut)[2] == 3);
+  REQUIRE(sut.initialized());
+  REQUIRE(calls == 1);
+}
+
+TEST_CASE("Lazy Initializer is destroyed after it has run.") {
+  auto shared = std::make_shared<int>(7);
+  ibex::Lazy<int, 32> sut([shared] { return *shared; });
+  REQUIRE(shared.use_count() == 2);
+
+  REQUIRE(sut.get() == 7);
+  REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("Lazy A throwing initializer is retried.") {
+  int calls = 0;
+  ibex::Lazy<int, 32> sut([&calls] {
+    if (++calls == 1) throw std::runtime_error("first");
+    return calls;
+  });
+
+  REQUIRE_THROWS_AS(sut.get(), std::runtime_error);
+  REQUIRE_FALSE(sut.initialized());
+  REQUIRE(sut.get() == 2);
+}
+
+TEST_CASE("Lazy Initializer runs exactly once under contention.") {
+  std::atomic<int> calls{0};
+  ibex::Lazy<int, 32> sut([&calls] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return ++calls;
+  });
+
+  std::vector<int> values(8);
+  std::vector<std::thread> threads;
+  for (auto& value : values) {
+    threads.emplace_back([&sut, &value] { value = sut.get(); });
+  }
+  for (auto& thread : threads) thread.join();
+
+  REQUIRE(calls == 1);
+  REQUIRE(values == std::vector<int>(8, 1));
+}
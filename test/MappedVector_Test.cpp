@@ -0,0 +1,110 @@
+#include <ibex/MappedVector.h>
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+  struct Record {
+    std::uint64_t key;
+    double value;
+  };
+
+  // Removes the file when the test ends
+  struct TemporaryFile {
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("ibex_mapped_" + std::to_string(::getpid())))
+                           .string();
+    ~TemporaryFile() { std::filesystem::remove(path); }
+  };
+}
+
+TEST_CASE("MappedVector Elements survive reopening.") {
+  TemporaryFile file;
+  {
+    ibex::MappedVector<Record> sut(file.path, ibex::MapMode::Truncate, 7);
+    REQUIRE(sut.empty());
+    for (std::uint64_t i = 0; i < 1000; ++i) sut.pushBack({i, i * 0.5});
+    REQUIRE(sut.size() == 1000);
+    REQUIRE(sut.capacity() >= 1000);
+    sut.flush();
+  }
+
+  const ibex::MappedVector<Record> sut(file.path, ibex::MapMode::ReadOnly, 7);
+  REQUIRE(sut.readOnly());
+  REQUIRE(sut.size() == 1000);
+  REQUIRE(sut[999].key == 999);
+  REQUIRE(sut.at(10).value == 5.0);
+  REQUIRE_THROWS_AS(sut.at(1000), std::out_of_range);
+}
+
+TEST_CASE("MappedVector Growth keeps the elements.") {
+  TemporaryFile file;
+  ibex::MappedVector<int> sut(file.path, ibex::MapMode::Truncate);
+
+  sut.resize(10);
+  REQUIRE(sut[9] == 0);
+  sut.reserve(100000);
+  REQUIRE(sut.capacity() == 100000);
+  for (int i = 0; i < 100000; ++i) sut.emplaceBack(i);
+  REQUIRE(sut.size() == 100010);
+  REQUIRE(sut.back() == 99999);
+  sut.popBack();
+  REQUIRE(sut.size() == 100009);
+
+  ibex::MappedVector<int> reopened(file.path, ibex::MapMode::ReadWrite);
+  REQUIRE(reopened.size() == 100009);
+  REQUIRE(reopened[10] == 0);
+  REQUIRE(reopened[11] == 1);
+}
+
+TEST_CASE("MappedVector Mismatching files are rejected.") {
+  TemporaryFile file;
+  {
+    ibex::MappedVector<Record> sut(file.path, ibex::MapMode::Truncate, 7);
+    sut.pushBack({1, 1.0});
+  }
+
+  REQUIRE_THROWS_AS(
+      ibex::MappedVector<Record>(file.path, ibex::MapMode::ReadOnly, 8),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(
+      ibex::MappedVector<int>(file.path, ibex::MapMode::ReadOnly, 7),
+      std::runtime_error);
+  REQUIRE_THROWS_AS(
+      ibex::MappedVector<int>(file.path + ".missing", ibex::MapMode::ReadOnly),
+      std::system_error);
+
+  ibex::MappedVector<Record> sut(file.path, ibex::MapMode::ReadOnly, 7);
+  REQUIRE_THROWS_AS(sut.pushBack({2, 2.0}), std::logic_error);
+}
+
+TEST_CASE("MappedVector Appending an own element while growing.") {
+  TemporaryFile file;
+  ibex::MappedVector<Record> sut(file.path, ibex::MapMode::Truncate);
+
+  sut.pushBack({1, 1.5});
+  for (int i = 0; i < 4; ++i) {
+    while (sut.size() < sut.capacity()) sut.pushBack(sut[0]);
+    sut.pushBack(sut[0]);
+    while (sut.size() < sut.capacity()) sut.pushBack(sut[0]);
+    sut.emplaceBack(sut.back());
+  }
+  for (const Record& record : sut) {
+    REQUIRE(record.key == 1);
+    REQUIRE(record.value == 1.5);
+  }
+}
+
+TEST_CASE("MappedVector Moved-from vectors are empty.") {
+  TemporaryFile file;
+  ibex::MappedVector<int> sut(file.path, ibex::MapMode::Truncate);
+  sut.pushBack(1);
+
+  ibex::MappedVector<int> moved(std::move(sut));
+  REQUIRE(sut.size() == 0);
+  REQUIRE(sut.empty());
+  REQUIRE(sut.capacity() == 0);
+  REQUIRE(moved.size() == 1);
+}
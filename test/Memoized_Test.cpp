@@ -0,0 +1,166 @@
+#include <ibex/Memoized.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Memoized Repeated keys are served from the cache.") {
+  int calls = 0;
+  ibex::Memoized<std::string(int), 32> sut([&calls](int i) {
+    ++calls;
+    return std::to_string(i * i);
+  });
+
+  REQUIRE(sut(12) == "144");
+  REQUIRE(sut(12) == "144");
+  REQUIRE(sut(3) == "9");
+
+  REQUIRE(calls == 2);
+  REQUIRE(sut.stats().hits == 1);
+  REQUIRE(sut.stats().misses == 2);
+}
+
+TEST_CASE("Memoized The cache is bounded and still returns correct results.") {
+  int calls = 0;
+  ibex::Memoized<int(int), 32, 8> sut([&calls](int i) {
+    ++calls;
+    return -i;
+  });
+
+  for (int i = 0; i < 100; ++i) REQUIRE(sut(i) == -i);
+  REQUIRE(sut(99) == -99);
+  REQUIRE(calls == 100);
+
+  REQUIRE(sut(0) == 0);
+  REQUIRE(calls == 101);
+}
+
+TEST_CASE("Memoized Clearing drops cached results.") {
+  int calls = 0;
+  ibex::Memoized<int(const std::string&), 32> sut(
+      [&calls](const std::string& s) {
+        ++calls;
+        return int(s.size());
+      });
+
+  sut("ibex");
+  sut.clear();
+  sut("ibex");
+
+  REQUIRE(calls == 2);
+}
+
+TEST_CASE("Memoized Per-thread caches are filled independently.") {
+  std::atomic<int> calls{0};
+  ibex::Memoized<long(long), 32, 64, true> sut([&calls](long i) {
+    ++calls;
+    return 2 * i;
+  });
+
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&sut, &wrong] {
+      for (int round = 0; round < 10; ++round) {
+        for (long i = 0; i < 16; ++i) wrong += sut(i) != 2 * i;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  REQUIRE(wrong == 0);
+  REQUIRE(calls == 4 * 16);
+  REQUIRE(sut.stats().misses == 4 * 16);
+  REQUIRE(sut.stats().hits == 4 * 9 * 16);
+}
+
+TEST_CASE("Memoized Moving keeps the target and the cached results.") {
+  int calls = 0;
+  const auto make = [&calls] {
+    return ibex::Memoized<int(int), 64, 16>([&calls](int x) {
+      ++calls;
+      return x * 2;
+    });
+  };
+  std::vector<ibex::Memoized<int(int), 64, 16>> sut;
+  sut.push_back(make());
+  sut[0](4);
+  sut.push_back(make());  // Relocates the first one
+
+  REQUIRE(sut[0](4) == 8);
+  REQUIRE(sut[0].stats().hits == 1);
+  REQUIRE(calls == 1);
+}
+
+TEST_CASE("Memoized Moving keeps per-thread caches.") {
+  ibex::Memoized<int(int), 64, 16, true> source([](int x) { return x + 1; });
+  source(1);
+
+  auto sut = std::move(source);
+
+  REQUIRE(sut(1) == 2);
+  REQUIRE(sut.stats().hits == 1);
+}
+
+TEST_CASE("Memoized Caches of exited threads are released.") {
+  auto shared = std::make_shared<int>(0);
+  ibex::Memoized<std::shared_ptr<int>(int), 32, 64, true> sut(
+      [shared](int) { return shared; });
+
+  std::thread([&sut] {
+    sut(1);
+    sut(1);
+  }).join();
+
+  REQUIRE(shared.use_count() == 2);
+  REQUIRE(sut.stats().hits == 1);
+  REQUIRE(sut.stats().misses == 1);
+}
+
+TEST_CASE("Memoized Many per-thread instances keep their caches.") {
+  int calls = 0;
+  std::vector<ibex::Memoized<int(int), 32, 16, true>> sut;
+  for (int i = 0; i < 64; ++i) {
+    sut.emplace_back([&calls, i](int x) {
+      ++calls;
+      return x + i;
+    });
+  }
+
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 64; ++i) REQUIRE(sut[i](1) == 1 + i);
+  }
+  sut.erase(sut.begin(), sut.begin() + 32);
+  for (int i = 0; i < 32; ++i) REQUIRE(sut[i](1) == 33 + i);
+
+  REQUIRE(calls == 64);
+  for (auto& memoized : sut) REQUIRE(memoized.stats().hits == 3);
+}
+
+namespace {
+  using PerThreadMemoized = ibex::Memoized<int(int), 32, 16, true>;
+
+  // Destroyed after its thread has released its caches
+  struct LateCall {
+    PerThreadMemoized* memoized{nullptr};
+    int* result{nullptr};
+    ~LateCall() { *result = (*memoized)(2); }
+  };
+}
+
+TEST_CASE("Memoized Thread-local objects may call during thread exit.") {
+  PerThreadMemoized sut([](int x) { return x * 3; });
+  int result = 0;
+
+  std::thread([&] {
+    thread_local LateCall late;
+    late.memoized = &sut;
+    late.result = &result;
+    sut(1);
+  }).join();
+
+  REQUIRE(result == 6);
+}
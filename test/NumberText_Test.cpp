@@ -0,0 +1,139 @@
+#include <ibex/NumberText.h>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace {
+  template <typename T>
+  std::string format(T value) {
+    char buffer[ibex::kMaxFloatChars];
+    if constexpr (std::is_integral_v<T>) {
+      return std::string(buffer, ibex::formatInteger(buffer, value));
+    } else {
+      return std::string(buffer, ibex::formatFloat(buffer, value));
+    }
+  }
+
+  template <typename T, typename = void>
+  struct CanFormatFloat : std::false_type {};
+
+  template <typename T>
+  struct CanFormatFloat<T, std::void_t<decltype(ibex::formatFloat(
+                               std::declval<char*>(), std::declval<T>()))>>
+      : std::true_type {};
+}
+
+TEST_CASE("NumberText Only floats and doubles are formatted.") {
+  static_assert(CanFormatFloat<float>::value);
+  static_assert(CanFormatFloat<double>::value);
+  static_assert(!CanFormatFloat<long double>::value);
+}
+
+TEST_CASE("NumberText Integers are formatted like std::to_string.") {
+  REQUIRE(format(0) == "0");
+  REQUIRE(format(7u) == "7");
+  REQUIRE(format(-42) == "-42");
+  REQUIRE(format(std::int8_t(-128)) == "-128");
+  REQUIRE(format(std::numeric_limits<std::int64_t>::min()) ==
+          "-9223372036854775808");
+  REQUIRE(format(std::numeric_limits<std::uint64_t>::max()) ==
+          "18446744073709551615");
+
+  std::mt19937_64 rng(5);
+  for (int i = 0; i < 10000; ++i) {
+    const std::uint64_t value = rng() >> (rng() % 64);
+    REQUIRE(format(value) == std::to_string(value));
+  }
+  std::uint64_t power = 1;
+  for (int i = 0; i < 19; ++i, power *= 10) {
+    REQUIRE(format(power) == std::to_string(power));
+    REQUIRE(format(power - 1) == std::to_string(power - 1));
+  }
+}
+
+TEST_CASE("NumberText Digits are zero-padded to the width.") {
+  char buffer[8];
+
+  REQUIRE(std::string(buffer, ibex::formatDigits(buffer, 42, 5)) == "00042");
+  REQUIRE(std::string(buffer, ibex::formatDigits(buffer, 20261018, 8)) ==
+          "20261018");
+  REQUIRE(std::string(buffer, ibex::formatDigits(buffer, 1234, 2)) == "34");
+}
+
+TEST_CASE("NumberText Floats are formatted shortest and round trip.") {
+  REQUIRE(format(0.1) == "0.1");
+  REQUIRE(format(-2.5) == "-2.5");
+  REQUIRE(format(1e22) == "1e+22");
+  REQUIRE(format(0.1f) == "0.1");
+  REQUIRE(format(std::numeric_limits<double>::lowest()).size() <=
+          ibex::kMaxFloatChars);
+
+  std::mt19937_64 rng(9);
+  for (int i = 0; i < 10000; ++i) {
+    std::uint64_t bits = rng();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (!std::isfinite(value)) continue;
+    const std::string text = format(value);
+    REQUIRE(text.size() <= ibex::kMaxFloatChars);
+    REQUIRE(std::strtod(text.c_str(), nullptr) == value);
+  }
+}
+
+TEST_CASE("NumberText Fixed-width fields are parsed.") {
+  const std::string_view record = "20261018123456789012345";
+
+  REQUIRE(ibex::parseDigits(record.data(), 8) == 20261018u);
+  REQUIRE(ibex::parseDigits(record.data() + 4, 4) == 1018u);
+  REQUIRE(ibex::parseDigits(record.data(), 16) == 2026101812345678u);
+  REQUIRE(ibex::parseDigits(record.data(), 19) == 2026101812345678901u);
+  REQUIRE(ibex::parseDigits(record.data() + 3, 11) == 61018123456u);
+  REQUIRE(ibex::parseDigits("0000000000000", 13) == 0u);
+
+  for (std::size_t width = 1; width <= 19; ++width) {
+    CAPTURE(width);
+    for (std::size_t bad = 0; bad < width; ++bad) {
+      std::string field(width, '7');
+      field[bad] = bad % 2 ? ':' : '/';  // Just above and below the digits
+      REQUIRE_FALSE(ibex::parseDigits(field.data(), width));
+    }
+  }
+}
+
+TEST_CASE("NumberText Integers are parsed with range checks.") {
+  REQUIRE(ibex::parseInteger<int>("-42") == -42);
+  REQUIRE(ibex::parseInteger<int>("000123") == 123);
+  REQUIRE(ibex::parseInteger<int>("-0") == 0);
+  REQUIRE(ibex::parseInteger<std::int8_t>("-128") == std::int8_t(-128));
+  REQUIRE_FALSE(ibex::parseInteger<std::int8_t>("128"));
+  REQUIRE_FALSE(ibex::parseInteger<unsigned>("-1"));
+  REQUIRE(ibex::parseInteger<std::uint64_t>("18446744073709551615") ==
+          std::numeric_limits<std::uint64_t>::max());
+  REQUIRE_FALSE(ibex::parseInteger<std::uint64_t>("18446744073709551616"));
+  REQUIRE_FALSE(ibex::parseInteger<std::uint64_t>("99999999999999999999"));
+  REQUIRE_FALSE(ibex::parseInteger<std::uint64_t>("100000000000000000000"));
+  REQUIRE(ibex::parseInteger<std::int64_t>("-9223372036854775808") ==
+          std::numeric_limits<std::int64_t>::min());
+  REQUIRE_FALSE(ibex::parseInteger<std::int64_t>("9223372036854775808"));
+  REQUIRE_FALSE(ibex::parseInteger<int>(""));
+  REQUIRE_FALSE(ibex::parseInteger<int>("-"));
+  REQUIRE_FALSE(ibex::parseInteger<int>("12a"));
+  REQUIRE_FALSE(ibex::parseInteger<int>("+1"));
+
+  std::mt19937_64 rng(11);
+  for (int i = 0; i < 10000; ++i) {
+    const auto value = std::int64_t(rng() >> (rng() % 64));
+    REQUIRE(ibex::parseInteger<std::int64_t>(format(value)) == value);
+    REQUIRE(ibex::parseInteger<std::int64_t>(format(-value)) == -value);
+  }
+}
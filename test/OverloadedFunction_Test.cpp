@@ -0,0 +1,62 @@
+#include <ibex/OverloadedFunction.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+
+namespace {
+  struct Request {
+    std::string path;
+  };
+  struct Timeout {};
+  struct Close {};
+
+  using Handler = ibex::OverloadedFunction<32, int(Request&), int(Timeout),
+                                           int(Close)>;
+
+  struct Connection {
+    std::shared_ptr<int> events = std::make_shared<int>(0);
+
+    int operator()(Request& request) {
+      request.path += "/handled";
+      return ++*events;
+    }
+    int operator()(Timeout) { return -1; }
+    int operator()(Close) { return *events; }
+  };
+}
+
+TEST_CASE("OverloadedFunction Default function is invalid") {
+  Handler sut;
+
+  REQUIRE_FALSE(sut);
+  REQUIRE_THROWS_AS(sut(Close{}), std::bad_function_call);
+}
+
+TEST_CASE("OverloadedFunction Each signature reaches the same target.") {
+  Handler sut{Connection{}};
+  Request request{"/index"};
+
+  REQUIRE(sut(request) == 1);
+  REQUIRE(sut(request) == 2);
+  REQUIRE(sut(Timeout{}) == -1);
+  REQUIRE(sut(Close{}) == 2);
+  REQUIRE(request.path == "/index/handled/handled");
+}
+
+TEST_CASE("OverloadedFunction Moving keeps the shared state once.") {
+  Connection connection;
+  const auto events = connection.events;
+  Handler sut{std::move(connection)};
+  REQUIRE(events.use_count() == 2);
+
+  Handler moved = std::move(sut);
+  Handler assigned;
+  assigned = std::move(moved);
+
+  REQUIRE_FALSE(sut);
+  REQUIRE_FALSE(moved);
+  REQUIRE(events.use_count() == 2);
+  REQUIRE(assigned(Close{}) == 0);
+}
@@ -0,0 +1,48 @@
+#include <ibex/PackedIntVector.h>
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+TEST_CASE("PackedIntVector Values are accessed at random.") {
+  std::mt19937 rng(11);
+  std::vector<std::uint32_t> values(1000);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = 1700000000 + std::uint32_t(i) * 3 + rng() % 1000;
+  }
+  values[300] = UINT32_MAX;  // One block needs all 32 bits
+  values[600] = 0;
+
+  ibex::PackedIntVector packed;
+  REQUIRE(packed.empty());
+  for (const std::uint32_t value : values) packed.pushBack(value);
+  REQUIRE(packed.size() == values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    REQUIRE(packed[i] == values[i]);
+  }
+  REQUIRE(packed.back() == values.back());
+  REQUIRE(packed.at(999) == values[999]);
+  REQUIRE_THROWS_AS(packed.at(1000), std::out_of_range);
+  REQUIRE(packed.toVector() == values);
+
+  packed.clear();
+  REQUIRE(packed.empty());
+  REQUIRE(packed.bytesUsed() == 0);
+}
+
+TEST_CASE("PackedIntVector Clustered values take a fraction of the space.") {
+  std::mt19937 rng(13);
+  std::vector<std::uint32_t> values(128 * 100);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = 50000 + std::uint32_t(i) + rng() % 64;
+  }
+  const ibex::PackedIntVector packed(values);
+  REQUIRE(packed.toVector() == values);
+  // Spread within a block is below 256, i.e. 8 bits per value
+  REQUIRE(packed.bytesUsed() * 3 < values.size() * sizeof(std::uint32_t));
+
+  const ibex::PackedIntVector constant(std::vector<std::uint32_t>(256, 9));
+  REQUIRE(constant[255] == 9);
+  REQUIRE(constant.bytesUsed() < 64);
+}
@@ -0,0 +1,80 @@
+#include <ibex/Arena.h>
+#include <ibex/PageMemory.h>
+#include <ibex/Pool.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <set>
+#include <utility>
+
+TEST_CASE("PageMemory Regular mappings are page aligned and writable.") {
+  ibex::PageMemory sut(100, {ibex::HugePages::Off, true});
+
+  REQUIRE(sut.backing() == ibex::PageMemory::Backing::Regular);
+  REQUIRE(sut.size() == ibex::PageMemory::pageSize());
+  REQUIRE(reinterpret_cast<std::uintptr_t>(sut.data()) %
+              ibex::PageMemory::pageSize() ==
+          0);
+  std::memset(sut.data(), 0xab, sut.size());
+  REQUIRE(sut.hugePageBytes() == 0);
+}
+
+TEST_CASE("PageMemory Huge page requests fall back transparently.") {
+  for (auto hugePages :
+       {ibex::HugePages::Transparent, ibex::HugePages::Explicit}) {
+    ibex::PageMemory sut(3 * 1024 * 1024, {hugePages, true});
+
+    REQUIRE(sut.size() == 2 * ibex::PageMemory::kHugePageSize);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(sut.data()) %
+                ibex::PageMemory::kHugePageSize ==
+            0);
+    std::memset(sut.data(), 0xab, sut.size());
+    REQUIRE(sut.hugePageBytes() <= sut.size());
+  }
+}
+
+TEST_CASE("Arena Allocations are aligned and reused after reset.") {
+  ibex::Arena sut(4096);
+
+  void* first = sut.allocate(10, 64);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(first) % 64 == 0);
+  int* value = sut.create<int>(42);
+  REQUIRE(*value == 42);
+  void* big = sut.allocate(10000);
+  std::memset(big, 0, 10000);
+  REQUIRE(sut.bytesReserved() >= 4096 + 10000);
+
+  const std::size_t reserved = sut.bytesReserved();
+  sut.reset();
+  REQUIRE(sut.allocate(10, 64) == first);
+  REQUIRE(sut.bytesReserved() == reserved);
+}
+
+TEST_CASE("Arena Moved-from arenas start over.") {
+  ibex::Arena a(4096);
+  a.allocate(64);
+  ibex::Arena b(std::move(a));
+  REQUIRE(a.bytesReserved() == 0);
+
+  a.reserve(4096);
+  REQUIRE(a.allocate(64) != b.allocate(64));
+
+  ibex::Arena c(4096);
+  c = std::move(b);
+  REQUIRE(b.bytesReserved() == 0);
+  REQUIRE(b.allocate(64) != c.allocate(64));
+}
+
+TEST_CASE("Pool Freed blocks are handed out again.") {
+  ibex::Pool sut(24, 16);
+  REQUIRE(sut.blockSize() == 32);
+
+  std::set<void*> blocks;
+  for (int i = 0; i < 40; ++i) blocks.insert(sut.allocate());
+  REQUIRE(blocks.size() == 40);
+
+  void* block = *blocks.begin();
+  sut.deallocate(block);
+  REQUIRE(sut.allocate() == block);
+}
@@ -0,0 +1,127 @@
+#include <ibex/RecordReader.h>
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+namespace {
+  // Writes contents to a file that is removed when the test ends
+  struct TemporaryFile {
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("ibex_records_" + std::to_string(::getpid())))
+                           .string();
+
+    explicit TemporaryFile(const std::string& contents) {
+      std::ofstream(path, std::ios::binary) << contents;
+    }
+    ~TemporaryFile() { std::filesystem::remove(path); }
+  };
+
+  std::vector<std::size_t> naiveFind(const std::string& text, char c) {
+    std::vector<std::size_t> offsets;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      if (text[i] == c) offsets.push_back(i);
+    }
+    return offsets;
+  }
+}
+
+TEST_CASE("RecordReader Kernels find every delimiter.") {
+  std::mt19937 rng(1);
+  for (std::size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+    std::string text(size, 'a');
+    for (auto& c : text) c = rng() % 4 == 0 ? '\n' : 'a';
+    const auto expected = naiveFind(text, '\n');
+
+    std::vector<std::size_t> found;
+    auto collect = [&](std::size_t offset) { found.push_back(offset); };
+    ibex::detail::findAll(text.data(), text.size(), '\n', collect);
+    REQUIRE(found == expected);
+
+    found.clear();
+    ibex::detail::findAllScalar(text.data(), text.size(), '\n', collect);
+    REQUIRE(found == expected);
+#ifdef IBEX_RECORD_READER_SIMD
+    found.clear();
+    ibex::detail::findAllSse2(text.data(), text.size(), '\n', collect);
+    REQUIRE(found == expected);
+    if (ibex::detail::hasAvx2()) {
+      found.clear();
+      ibex::detail::findAllAvx2(text.data(), text.size(), '\n', collect);
+      REQUIRE(found == expected);
+    }
+#endif
+  }
+}
+
+TEST_CASE("RecordReader Yields lines without copying.") {
+  const std::string third = "third line is longer than thirty-two bytes";
+  TemporaryFile file("first\n\n" + third + "\nlast");
+  ibex::RecordReader sut(file.path);
+
+  std::vector<std::string_view> lines;
+  auto collect = [&](std::string_view line) { lines.push_back(line); };
+  REQUIRE(sut.forEach(collect) == 4);
+  REQUIRE(lines ==
+          std::vector<std::string_view>{"first", "", third, "last"});
+  REQUIRE(lines[0].data() == sut.data().data());
+
+  std::size_t batches = 0;
+  std::size_t records = 0;
+  sut.forEachBatch(
+      [&](const std::string_view*, std::size_t count) {
+        ++batches;
+        records += count;
+      },
+      3);
+  REQUIRE(batches == 2);
+  REQUIRE(records == 4);
+}
+
+TEST_CASE("RecordReader Splits fields.") {
+  std::vector<std::string_view> fields;
+  const auto count = ibex::splitFields(
+      "a,,ccc,", ',', [&](std::string_view field) { fields.push_back(field); });
+  REQUIRE(count == 4);
+  REQUIRE(fields == std::vector<std::string_view>{"a", "", "ccc", ""});
+}
+
+TEST_CASE("RecordReader Parallel chunks cover every record once.") {
+  std::string contents;
+  for (int i = 0; i < 10000; ++i) contents += std::to_string(i) + "\n";
+  TemporaryFile file(contents);
+  ibex::RecordReader sut(file.path);
+
+  const auto chunks = sut.split(1000);
+  REQUIRE(chunks.size() > 10);
+  for (const auto& chunk : chunks) REQUIRE(chunk.back() == '\n');
+
+  std::vector<long> sums(chunks.size());
+  const auto count = sut.forEachParallel(
+      [&](std::size_t chunk, std::string_view record) {
+        sums[chunk] += std::stol(std::string(record));
+      },
+      4, 1000);
+  REQUIRE(count == 10000);
+  long total = 0;
+  for (long sum : sums) total += sum;
+  REQUIRE(total == 9999L * 10000 / 2);
+
+  REQUIRE_THROWS_AS(
+      sut.forEachParallel(
+          [](std::size_t, std::string_view) { throw std::runtime_error(""); },
+          4, 1000),
+      std::runtime_error);
+}
+
+TEST_CASE("RecordReader Handles empty and missing files.") {
+  TemporaryFile file("");
+  ibex::RecordReader sut(file.path);
+  REQUIRE(sut.forEach([](std::string_view) {}) == 0);
+  REQUIRE(sut.forEachParallel([](std::size_t, std::string_view) {}) == 0);
+  REQUIRE_THROWS_AS(ibex::RecordReader(file.path + ".missing"),
+                    std::system_error);
+}
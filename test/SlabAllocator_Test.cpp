@@ -0,0 +1,124 @@
+#include <ibex/SlabAllocator.h>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SlabAllocator Blocks are aligned, distinct and reused.") {
+  ibex::SlabAllocator sut;
+
+  std::set<void*> blocks;
+  for (std::size_t size : {1, 8, 17, 100, 500, 1024}) {
+    for (std::size_t alignment : {8, 16, 64, 256}) {
+      void* block = sut.allocate(size, alignment);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(block) % alignment == 0);
+      std::memset(block, 0xab, size);
+      REQUIRE(blocks.insert(block).second);
+    }
+  }
+
+  void* block = sut.allocate(48);
+  sut.deallocate(block, 48);
+  REQUIRE(sut.allocate(40) == block);
+  REQUIRE(sut.bytesMapped() > 0);
+}
+
+TEST_CASE("SlabAllocator Large requests go to the upstream resource.") {
+  ibex::SlabAllocator sut;
+
+  void* block = sut.allocate(4096, 64);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(block) % 64 == 0);
+  std::memset(block, 0, 4096);
+  sut.deallocate(block, 4096, 64);
+  REQUIRE(sut.bytesMapped() == 0);
+}
+
+TEST_CASE("SlabAllocator Blocks freed by other threads are reclaimed.") {
+  ibex::SlabAllocator sut;
+  constexpr std::size_t count = 10000;
+
+  std::vector<void*> blocks;
+  for (std::size_t i = 0; i < count; ++i) blocks.push_back(sut.allocate(64));
+  const std::set<void*> allocated(blocks.begin(), blocks.end());
+
+  std::vector<std::thread> consumers;
+  for (std::size_t t = 0; t < 4; ++t) {
+    consumers.emplace_back([&, t] {
+      for (std::size_t i = t; i < count; i += 4) sut.deallocate(blocks[i], 64);
+    });
+  }
+  for (auto& consumer : consumers) consumer.join();
+
+  std::set<void*> reused;
+  for (std::size_t i = 0; i < count; ++i) reused.insert(sut.allocate(64));
+  REQUIRE(reused == allocated);
+}
+
+TEST_CASE("SlabAllocator Heaps of exited threads are adopted.") {
+  ibex::SlabAllocator sut;
+
+  void* first = nullptr;
+  std::thread([&] {
+    first = sut.allocate(64);
+    sut.deallocate(first, 64);
+  }).join();
+  const std::size_t mapped = sut.bytesMapped();
+
+  // Keeps the id of the exited thread taken, which may be reused
+  std::atomic<bool> done{false};
+  std::thread idle([&done] {
+    while (!done) std::this_thread::yield();
+  });
+  void* second = nullptr;
+  std::thread([&] { second = sut.allocate(64); }).join();
+  done = true;
+  idle.join();
+
+  REQUIRE(second == first);
+  REQUIRE(sut.bytesMapped() == mapped);
+}
+
+namespace {
+  // Destroyed after the heaps of its thread have been handed back
+  struct LateRelease {
+    ibex::SlabAllocator* allocator{nullptr};
+    void* block{nullptr};
+    ~LateRelease() {
+      allocator->deallocate(block, 64);
+      allocator->deallocate(allocator->allocate(32), 32);
+    }
+  };
+}
+
+TEST_CASE("SlabAllocator Thread-local objects may free during thread exit.") {
+  ibex::SlabAllocator sut;
+
+  void* block = nullptr;
+  std::thread([&] {
+    thread_local LateRelease late;
+    late.allocator = &sut;
+    late.block = block = sut.allocate(64);
+  }).join();
+
+  void* reused = nullptr;
+  std::thread([&] { reused = sut.allocate(64); }).join();
+  REQUIRE(reused == block);
+}
+
+TEST_CASE("SlabAllocator Works as a std::pmr::memory_resource.") {
+  ibex::SlabAllocator sut;
+
+  std::pmr::map<int, std::pmr::string> map(&sut);
+  for (int i = 0; i < 1000; ++i) {
+    map.emplace(i, "a string that does not fit into the small buffer");
+  }
+  REQUIRE(map.size() == 1000);
+  REQUIRE(map.at(500).get_allocator().resource() == &sut);
+  REQUIRE(sut.is_equal(sut));
+}
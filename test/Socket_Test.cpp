@@ -0,0 +1,129 @@
+#include <ibex/Socket.h>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Socket Addresses are parsed and printed.") {
+  const ibex::SocketAddress v4("127.0.0.1", 8080);
+  REQUIRE(v4.family() == AF_INET);
+  REQUIRE(v4.port() == 8080);
+  REQUIRE(v4.toString() == "127.0.0.1:8080");
+
+  const ibex::SocketAddress v6("::1", 53);
+  REQUIRE(v6.family() == AF_INET6);
+  REQUIRE(v6.toString() == "[::1]:53");
+
+  REQUIRE_THROWS_AS(ibex::SocketAddress("localhost", 1),
+                    std::invalid_argument);
+}
+
+TEST_CASE("Socket Datagrams are sent and received in batches.") {
+  ibex::UdpSocket receiver(ibex::SocketAddress::loopback());
+  ibex::UdpSocket sender(ibex::SocketAddress::loopback());
+  const ibex::SocketAddress target = receiver.localAddress();
+  REQUIRE(target.port() != 0);
+
+  std::vector<std::string> payloads;
+  std::vector<ibex::Datagram> datagrams;
+  for (int i = 0; i < 10; ++i) payloads.push_back("datagram " + std::to_string(i));
+  for (const auto& payload : payloads) {
+    datagrams.push_back(
+        {reinterpret_cast<const std::byte*>(payload.data()), payload.size(),
+         target});
+  }
+  REQUIRE(sender.send(datagrams.data(), datagrams.size()) == 10);
+
+  ibex::DatagramBatch batch(4, 64);
+  std::vector<std::string> received;
+  while (received.size() < 10) {
+    const std::size_t count = receiver.receive(batch);
+    REQUIRE(count <= 4);
+    for (const auto& datagram : batch) {
+      received.emplace_back(reinterpret_cast<const char*>(datagram.data),
+                            datagram.size);
+      REQUIRE(datagram.peer.port() == sender.localAddress().port());
+      REQUIRE_FALSE(datagram.truncated);
+    }
+  }
+  REQUIRE(received == payloads);
+  REQUIRE(receiver.receive(batch) == 0);
+
+  const std::string large(100, 'x');
+  REQUIRE(sender.send(large.data(), large.size(), target));
+  REQUIRE(receiver.receive(batch) == 1);
+  REQUIRE(batch[0].truncated);
+  REQUIRE(batch[0].size == 64);
+}
+
+TEST_CASE("Socket UdpReceiver drains the socket on edge-triggered events.") {
+  ibex::EventLoop loop;
+  ibex::UdpSocket socket(ibex::SocketAddress::loopback());
+  ibex::UdpSocket sender(ibex::SocketAddress::loopback());
+
+  std::size_t batches = 0;
+  std::size_t datagrams = 0;
+  {
+    ibex::UdpReceiver<> receiver(
+        loop, socket,
+        [&](const ibex::Datagram*, std::size_t count) {
+          ++batches;
+          datagrams += count;
+        },
+        8);
+    for (int i = 0; i < 20; ++i) {
+      REQUIRE(sender.send("ping", 4, socket.localAddress()));
+    }
+    while (datagrams < 20) REQUIRE(loop.runOnce(1000) == 1);
+    REQUIRE(batches >= 3);  // At most 8 per recvmmsg
+    REQUIRE(loop.size() == 1);
+  }
+  REQUIRE(loop.size() == 0);
+}
+
+TEST_CASE("Socket TCP streams write and read buffer chains.") {
+  ibex::BufferPool pool(4096);
+  ibex::EventLoop loop;
+  ibex::TcpListener listener(ibex::SocketAddress::loopback());
+  auto client = ibex::TcpStream::connect(listener.localAddress());
+
+  std::optional<ibex::TcpStream> server;
+  loop.add(listener.fd(), EPOLLIN | EPOLLET, [&](std::uint32_t) {
+    while (auto stream = listener.accept()) server = std::move(stream);
+  });
+  while (!server) loop.runOnce(1000);
+  REQUIRE_FALSE(listener.accept());
+
+  // 1 MiB in many slices, more than the socket buffers hold
+  ibex::BufferChain outgoing(pool);
+  std::string expected;
+  for (int i = 0; i < 1024; ++i) {
+    const std::string piece(1024, char('a' + i % 26));
+    outgoing.append(piece);
+    expected += piece;
+  }
+  ibex::BufferChain incoming(pool);
+  loop.add(server->fd(), EPOLLIN | EPOLLET,
+           [&](std::uint32_t) { server->read(incoming); });
+  loop.add(client.fd(), EPOLLOUT | EPOLLET, [&](std::uint32_t) {
+    client.write(outgoing);
+    if (outgoing.empty()) client.shutdownWrite();
+  });
+  while (!server->eof()) loop.runOnce(1000);
+
+  REQUIRE(outgoing.empty());
+  REQUIRE(incoming.size() == expected.size());
+  REQUIRE(incoming.toString() == expected);
+  loop.remove(server->fd());
+  loop.remove(client.fd());
+}
+
+TEST_CASE("Socket Connecting to a closed port throws.") {
+  ibex::SocketAddress address;
+  {
+    ibex::TcpListener listener(ibex::SocketAddress::loopback());
+    address = listener.localAddress();
+  }
+  REQUIRE_THROWS_AS(ibex::TcpStream::connect(address), std::system_error);
+}
@@ -0,0 +1,61 @@
+#include <ibex/StableVector.h>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <numeric>
+
+TEST_CASE("StableVector Element addresses do not change on growth.") {
+  ibex::StableVector<int, 4> sut;
+  int* first = &sut.emplaceBack(1);
+
+  for (int i = 2; i <= 100; ++i) sut.pushBack(i);
+
+  REQUIRE(first == &sut[0]);
+  REQUIRE(sut.size() == 100);
+  REQUIRE(sut[99] == 100);
+  REQUIRE(sut.back() == 100);
+}
+
+TEST_CASE("StableVector Chunks are recycled after shrinking.") {
+  ibex::StableVector<int, 4> sut;
+  for (int i = 0; i < 10; ++i) sut.pushBack(i);
+  const std::size_t capacity = sut.capacity();
+
+  while (!sut.empty()) sut.popBack();
+  for (int i = 0; i < 10; ++i) sut.pushBack(i);
+  REQUIRE(sut.capacity() == capacity);
+
+  sut.clear();
+  sut.shrinkToFit();
+  REQUIRE(sut.capacity() == 0);
+}
+
+TEST_CASE("StableVector Chunk iteration visits every element in order.") {
+  ibex::StableVector<int, 8> sut;
+  for (int i = 0; i < 20; ++i) sut.pushBack(i);
+  std::size_t chunks = 0;
+  int sum = 0;
+
+  sut.forEachChunk([&](int* data, std::size_t count) {
+    ++chunks;
+    sum = std::accumulate(data, data + count, sum);
+  });
+
+  REQUIRE(chunks == 3);
+  REQUIRE(sum == 190);
+  REQUIRE(std::accumulate(sut.begin(), sut.end(), 0) == 190);
+}
+
+TEST_CASE("StableVector Move-only elements are destroyed on clear.") {
+  ibex::StableVector<std::shared_ptr<int>, 2> sut;
+  auto shared = std::make_shared<int>(1);
+  for (int i = 0; i < 5; ++i) sut.pushBack(shared);
+
+  auto moved = std::move(sut);
+  REQUIRE(shared.use_count() == 6);
+
+  moved.clear();
+  REQUIRE(shared.use_count() == 1);
+  REQUIRE_THROWS_AS(moved.at(0), std::out_of_range);
+}
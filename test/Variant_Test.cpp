@@ -0,0 +1,118 @@
+#include <ibex/Variant.h>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+  struct Overloads {
+    int operator()(int i) const { return i; }
+    int operator()(double) const { return -1; }
+    int operator()(const std::string& s) const { return int(s.size()); }
+  };
+
+  template <std::size_t I>
+  struct Tag {
+    std::size_t value = I;
+  };
+}
+
+TEST_CASE("Variant Default variant holds first alternative.") {
+  ibex::Variant<int, double> sut;
+
+  REQUIRE(sut.index() == 0);
+  REQUIRE(sut.get<int>() == 0);
+}
+
+TEST_CASE("Variant Index uses the smallest type and copies are trivial.") {
+  using Small = ibex::Variant<char, bool>;
+
+  REQUIRE(sizeof(Small) == 2);
+  REQUIRE(std::is_trivially_copyable_v<Small>);
+  REQUIRE(ibex::is_trivially_relocatable_v<Small>);
+  REQUIRE_FALSE(std::is_trivially_copyable_v<ibex::Variant<int, std::string>>);
+}
+
+TEST_CASE("Variant Accessing the wrong alternative throws.") {
+  ibex::Variant<int, std::string> sut(std::string("ibex"));
+
+  REQUIRE(sut.holds<std::string>());
+  REQUIRE(sut.getIf<int>() == nullptr);
+  REQUIRE_THROWS_AS(sut.get<int>(), std::bad_variant_access);
+}
+
+TEST_CASE("Variant Visiting with few alternatives uses the active one.") {
+  ibex::Variant<int, double, std::string> sut(7);
+  REQUIRE(ibex::visit(Overloads{}, sut) == 7);
+
+  sut = std::string("four");
+  REQUIRE(ibex::visit(Overloads{}, sut) == 4);
+
+  const auto copy = sut;
+  REQUIRE(ibex::visit(Overloads{}, copy) == 4);
+}
+
+TEST_CASE("Variant Visiting with many alternatives uses the active one.") {
+  ibex::Variant<Tag<0>, Tag<1>, Tag<2>, Tag<3>, Tag<4>, Tag<5>, Tag<6>> sut;
+  sut.emplace<Tag<5>>();
+
+  REQUIRE(ibex::visit([](auto tag) { return tag.value; }, sut) == 5);
+}
+
+TEST_CASE("Variant Moving a move-only alternative keeps its value.") {
+  ibex::Variant<int, std::unique_ptr<int>> sut(std::make_unique<int>(3));
+  auto moved = std::move(sut);
+
+  REQUIRE(*moved.get<std::unique_ptr<int>>() == 3);
+}
+
+TEST_CASE("Variant Batch visitation groups elements by alternative.") {
+  std::vector<ibex::Variant<int, double>> sut{1, 2.5, 2, 3.5, 3};
+  std::vector<double> visited;
+
+  ibex::visitBatch([&](auto value) { visited.push_back(value); }, sut.data(),
+                   sut.size());
+
+  REQUIRE(visited == std::vector<double>{1, 2, 3, 2.5, 3.5});
+}
+
+TEST_CASE("Variant Batch visitation keeps the order of large arrays.") {
+  std::vector<ibex::Variant<int, double>> sut;
+  for (int i = 0; i < 2000; ++i) {
+    if (i % 3 == 0) {
+      sut.emplace_back(double(i));
+    } else {
+      sut.emplace_back(i);
+    }
+  }
+  std::vector<int> ints;
+  std::size_t doubles = 0;
+
+  ibex::visitBatch(
+      [&](auto value) {
+        if constexpr (std::is_same_v<decltype(value), int>) {
+          ints.push_back(value);
+        } else {
+          ++doubles;
+        }
+      },
+      sut.data(), sut.size());
+
+  REQUIRE(ints.size() + doubles == sut.size());
+  REQUIRE(std::is_sorted(ints.begin(), ints.end()));
+}
+
+TEST_CASE("Variant A throwing emplace leaves trivial alternatives valueless.") {
+  struct Throwing {
+    Throwing() { throw std::runtime_error("Throwing"); }
+  };
+  ibex::Variant<int, Throwing> sut(1);
+
+  REQUIRE_THROWS_AS(sut.emplace<Throwing>(), std::runtime_error);
+  REQUIRE(sut.valueless());
+}